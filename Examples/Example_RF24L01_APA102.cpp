@@ -1,4 +1,4 @@
-#include "../Libraries/RF24L01/RF24L01.hpp"
+#include "../Libraries/RF24L01/RF24L01_RX_Engine.hpp"
 #include "../Libraries/APA102/APA102.hpp"
 
 // This file is an example to which is used to Transmit and recieve RGB and brightness data from 4 Potentiometers
@@ -48,18 +48,20 @@ int main() {
 
     //Enable RX mode on RF24L01
     chip.start_RX();
-    std::array<uint8_t, 5> data_in = {0x00, 0x00, 0x00, 0x00};
+    //Receiver that empties the RX FIFO into a buffer of 8 packets when the IRQ-pin goes low
+    IPASS::RF24L01_RX_Engine<5, 8> receiver(chip);
+    IPASS::RF24L01_RX_Engine<5, 8>::packet packet_in = {};
     bool random_color = false;
     uint8_t counter = 0;
+    uint_fast64_t next_tick = hwlib::now_us();
     for (;;) {
+        receiver.poll();
 
-        //check if packet is recieved
-        if (chip.packet_received()) {
+        //handle all recieved packets
+        while (receiver.pop(packet_in)) {
             led.write(1);
-            //read rx_data to data in;
-            chip.read_rx(data_in);
             // if byte 5 == 0xff set random_color on true
-            if(data_in[4] == 0xff){
+            if(packet_in.data[4] == 0xff){
                 random_color=true;
             }
             else {
@@ -67,19 +69,19 @@ int main() {
                 random_color = false;
                 counter=0;
                 //write recieved data to the APA102
-                ledstrip.write({data_in[0], data_in[1], data_in[2]}, data_in[3]);
+                ledstrip.write({packet_in.data[0], packet_in.data[1], packet_in.data[2]}, packet_in.data[3]);
             }
         }
-        // if random_color == true
-        if(random_color){
+        // if random_color == true and 100 ms passed
+        if(random_color and hwlib::now_us() >= next_tick){
             //change color once every 7 runs
             if(counter%7==0){
                 ledstrip.random_colors();
             }
             // increase counter
             counter++;
+            next_tick = hwlib::now_us() + 100'000;
         }
-        hwlib::wait_ms(100);
     }
 }
 
@@ -0,0 +1,105 @@
+#include "../Libraries/RF24L01/RF24L01_Config.hpp"
+#include "../Libraries/RF24L01/RF24L01_Coroutine.hpp"
+
+// This file is an example of the transmitter of IPASS_RF24L01_TX written with coroutines, build it with
+// CPP_LANGUAGE := -std=c++20 in the project makefile
+
+// The example in this file concists of 2 coroutines on one scheduler:
+// - buttons() reads the buttons and the potentiometers and awaits the radio, without blocking the other coroutine
+// - heartbeat() blinks the LED while the radio traffic is in flight
+
+
+//! [Example_RF24L01_Coroutine_TX]
+
+//std::array containing the ADDRESS
+static constexpr std::array<uint8_t, 5> address = {0xe7, 0xe7, 0xe7, 0xe7, 0xe7};
+
+//Configuration of the RF24L01: channel 0x11, 1 Mbps and packagesize 5 on pipe 0, checked at compile time
+static constexpr IPASS::RF24L01_Config radio_config = IPASS::RF24L01_Config()
+        .rx_address(0, address)
+        .tx_address(address)
+        .channel(0x11)
+        .data_rate_2mbps(false)
+        .pipe(0, true, 5)
+        .pipe(1, false, 0);
+
+using scheduler = IPASS::Coroutine_Scheduler<4>;
+using radio = IPASS::RF24L01_Coroutine<5, 4, 4>;
+
+// Coroutine that sends the RGB and brightness values, {0,0,0,0} or a random color command when a button is pressed
+IPASS::Coroutine_Task<> buttons(scheduler &loop, radio &chip, hwlib::pin_in &send_value, hwlib::pin_in &turn_off,
+                                hwlib::pin_in &random_color, std::array<hwlib::adc *, 4> potentiometers) {
+    //data[0] is send first, the receiver reads it with read_rx() in the last element of its std::array
+    uint8_t data[5] = {};
+    for (;;) {
+        if (send_value.read()) {
+            data[0] = 0x00;
+            for (size_t i = 0; i < potentiometers.size(); i++) {
+                data[4 - i] = potentiometers[i]->read();
+            }
+        } else if (turn_off.read()) {
+            data[0] = data[1] = data[2] = data[3] = data[4] = 0x00;
+        } else if (random_color.read()) {
+            data[0] = 0xff;
+            data[1] = data[2] = data[3] = data[4] = 0x00;
+        } else {
+            co_await loop.sleep_us(10'000);
+            continue;
+        }
+        co_await chip.send(data, 5);
+        //wait until the button is released
+        while (send_value.read() or turn_off.read() or random_color.read()) {
+            co_await loop.sleep_us(10'000);
+        }
+    }
+}
+
+// Coroutine that blinks the LED
+IPASS::Coroutine_Task<> heartbeat(scheduler &loop, hwlib::pin_out &led) {
+    for (;;) {
+        led.write(true);
+        co_await loop.sleep_us(100'000);
+        led.write(false);
+        co_await loop.sleep_us(900'000);
+    }
+}
+
+int main_tx() {
+    //Kill the watchdog
+    WDT->WDT_MR = WDT_MR_WDDIS;
+
+    //Pins for the RF24L01
+    auto IRQ = hwlib::target::pin_in(hwlib::target::pins::d0);
+    auto clk = hwlib::target::pin_out(hwlib::target::pins::d3);
+    auto mosi = hwlib::target::pin_out(hwlib::target::pins::d2);
+    auto miso = hwlib::target::pin_in(hwlib::target::pins::d4);
+    auto RX_TX = hwlib::target::pin_out(hwlib::target::pins::d6);
+    auto minion_select = hwlib::target::pin_out(hwlib::target::pins::d8);
+    auto led = hwlib::target::pin_out(hwlib::target::pins::d7);
+
+    //SPI-bus for the RF24L01
+    auto spi_bus = hwlib::spi_bus_bit_banged_sclk_mosi_miso(clk, mosi, miso);
+
+    //ADC-Pins for the RGB and brightness values
+    auto red = hwlib::target::pin_adc(hwlib::target::ad_pins::a0);
+    auto green = hwlib::target::pin_adc(hwlib::target::ad_pins::a6);
+    auto blue = hwlib::target::pin_adc(hwlib::target::ad_pins::a8);
+    auto brightness = hwlib::target::pin_adc(hwlib::target::ad_pins::a10);
+
+    //Pins connected to the buttons
+    auto send_value = hwlib::target::pin_in(hwlib::target::pins::d52);
+    auto turn_off = hwlib::target::pin_in(hwlib::target::pins::d11);
+    auto random_color = hwlib::target::pin_in(hwlib::target::pins::d13);
+
+    IPASS::RF24L01 chip(spi_bus, RX_TX, minion_select, IRQ);
+    chip.apply<radio_config>();
+
+    scheduler loop;
+    radio transmitter(chip, loop);
+    loop.spawn(buttons(loop, transmitter, send_value, turn_off, random_color, {&red, &green, &blue, &brightness}));
+    loop.spawn(heartbeat(loop, led));
+    loop.run();
+    return 0;
+}
+
+//! [Example_RF24L01_Coroutine_TX]
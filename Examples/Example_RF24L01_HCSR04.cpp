@@ -44,7 +44,7 @@ int main_rx() {
     chip.change_RX_PW_P(0, 4);
 
     //Set datarate to 1Mbps
-    chip.setting_disable(IPASS::RF24L01::SETTING::RF_DR);
+    chip.setting_disable<IPASS::RF24L01::SETTING::RF_DR>();
 
     hwlib::wait_ms(200);
 
@@ -53,16 +53,20 @@ int main_rx() {
     std::array<uint8_t, 4> data_in = {0x00, 0x00, 0x00, 0x00};
 
     for (;;) {
+        //wait for the IRQ-pin instead of a fixed wait: the transmitter sends every 250 ms and the RX FIFO holds 3
+        //payloads, so a longer wait would leave payloads unacknowledged
+        while (not chip.interrupt_pending()) {
+            hwlib::wait_ms(1);
+        }
 
-        //check if packet is recieved
-        if (chip.packet_received()) {
-
-            //read rx_data to data in;
-            chip.read_rx(data_in);
-
+        //read all recieved packets
+        chip.drain_rx([&data_in](uint8_t, const uint8_t data[], size_t) {
+            //data[0] is the first byte on air, which write_tx() takes from the last element of the array
+            for (size_t i = 0; i < data_in.size(); i++) {
+                data_in[data_in.size() - 1 - i] = data[i];
+            }
             hwlib::cout << "distance: " << decode_distance(data_in) << " meter" <<'\n';
-        }
-        hwlib::wait_ms(1000);
+        }, data_in.size());
     }
 }
 
@@ -0,0 +1,804 @@
+//======================================================================================================================
+/**
+ *  @file      hwlib.hpp
+ *  @brief     IPASS-project: Host implementation of the part of hwlib used by the libraries, with a virtual clock and
+ *             recording and replaying fakes.
+ */
+//======================================================================================================================
+#ifndef IPASS_HOST_HWLIB_H
+#define IPASS_HOST_HWLIB_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+/**
+ * @brief
+ * Host replacement of hwlib
+ * @details
+ * Only the part of hwlib that the libraries use is available: pin_in, pin_out, the dummy pins, spi_bus with
+ * spi_transaction, spi_bus_bit_banged_sclk_mosi_miso, the wait functions, now_us(), rand() and cout. Time is virtual:
+ * it only moves when a wait function is called or when a pin or bus access costs time, so every run of a host program
+ * gives the same timing. The fakes to check and drive the libraries are in hwlib::host.
+ */
+namespace hwlib {
+
+    /**
+     * @brief
+     * Virtual clock and fakes of the host build
+     */
+    namespace host {
+        /**
+         * @brief
+         * the virtual time in ns
+         */
+        inline uint_fast64_t clock_ns = 0;
+        /**
+         * @brief
+         * the virtual time in ns that one pin access costs, the default is close to a pin access of the Arduino Due
+         */
+        inline uint_fast64_t pin_access_ns = 100;
+        /**
+         * @brief
+         * state of the pseudo-random generator of hwlib::rand()
+         */
+        inline uint32_t random_state = 1;
+        /**
+         * @brief
+         * function that's called after every step of the virtual clock, like an interrupt handler or a second
+         * microcontroller that runs at the same time, nullptr for none
+         */
+        inline void (*background)() = nullptr;
+        /**
+         * @brief
+         * boolean that's true while background runs, the steps of the clock inside background don't call it again
+         */
+        inline bool in_background = false;
+
+        /**
+         * @brief
+         * function to move the virtual clock forward
+         * @param ns the time in ns
+         */
+        inline void advance_ns(uint_fast64_t ns) {
+            clock_ns += ns;
+            if (background != nullptr and not in_background) {
+                in_background = true;
+                background();
+                in_background = false;
+            }
+        }
+
+        /**
+         * @brief
+         * function to set the virtual clock back to 0
+         */
+        inline void reset_clock() {
+            clock_ns = 0;
+        }
+    } //namespace host
+
+    /**
+     * @brief
+     * function to get the virtual time in us
+     * @return uint_fast64_t the virtual time in us
+     */
+    inline uint_fast64_t now_us() {
+        return host::clock_ns / 1000;
+    }
+
+    /**
+     * @brief
+     * function to get the virtual time in ticks
+     * @return uint_fast64_t the virtual time in ticks, see ticks_per_us()
+     */
+    inline uint_fast64_t now_ticks() {
+        return host::clock_ns;
+    }
+
+    /**
+     * @brief
+     * function to get the amount of ticks in 1 us, a tick of the host is 1 ns
+     * @return uint_fast64_t ticks per us
+     */
+    inline uint_fast64_t ticks_per_us() {
+        return 1000;
+    }
+
+    /**
+     * @brief
+     * function to wait, the virtual clock moves forward by the given time
+     * @param n the time in ns
+     */
+    inline void wait_ns(int_fast32_t n) {
+        if (n > 0) {
+            host::advance_ns(n);
+        }
+    }
+
+    /**
+     * @brief
+     * function to wait, the virtual clock moves forward by the given time
+     * @param n the time in us
+     */
+    inline void wait_us(int_fast32_t n) {
+        if (n > 0) {
+            host::advance_ns(static_cast<uint_fast64_t>(n) * 1000);
+        }
+    }
+
+    /**
+     * @brief
+     * function to wait, the virtual clock moves forward by the given time
+     * @param n the time in ms
+     */
+    inline void wait_ms(int_fast32_t n) {
+        if (n > 0) {
+            host::advance_ns(static_cast<uint_fast64_t>(n) * 1'000'000);
+        }
+    }
+
+    /**
+     * @brief
+     * function to get a pseudo-random number, seeded by host::random_state
+     * @return uint32_t pseudo-random number
+     */
+    inline uint32_t rand() {
+        host::random_state = host::random_state * 1103515245 + 12345;
+        return (host::random_state >> 16) | (host::random_state << 16);
+    }
+
+    /**
+     * @brief
+     * input pin
+     */
+    class pin_in {
+    public:
+        /**
+         * @brief
+         * function to read the level of the pin
+         * @return bool the level
+         */
+        virtual bool read() = 0;
+
+        /**
+         * @brief
+         * function to refresh the buffered level, does nothing for unbuffered pins
+         */
+        virtual void refresh() {}
+    };
+
+    /**
+     * @brief
+     * output pin
+     */
+    class pin_out {
+    public:
+        /**
+         * @brief
+         * function to write the level of the pin
+         * @param v the level
+         */
+        virtual void write(bool v) = 0;
+
+        /**
+         * @brief
+         * function to flush a buffered write, does nothing for unbuffered pins
+         */
+        virtual void flush() {}
+    };
+
+    /**
+     * @brief
+     * pin_in that always reads low
+     */
+    class pin_in_dummy_class : public pin_in {
+    public:
+        bool read() override {
+            return false;
+        }
+    };
+
+    /**
+     * @brief
+     * pin_out that ignores every write
+     */
+    class pin_out_dummy_class : public pin_out {
+    public:
+        void write(bool) override {}
+    };
+
+    /**
+     * @brief
+     * pin_in that always reads low
+     */
+    inline pin_in_dummy_class pin_in_dummy;
+    /**
+     * @brief
+     * pin_out that ignores every write
+     */
+    inline pin_out_dummy_class pin_out_dummy;
+
+    /**
+     * @brief
+     * manipulator to print integers hexadecimal
+     */
+    struct _setbase_hex {};
+    /**
+     * @brief
+     * manipulator to print integers decimal
+     */
+    struct _setbase_dec {};
+    /**
+     * @brief
+     * manipulator to print integers hexadecimal
+     */
+    inline constexpr _setbase_hex hex = {};
+    /**
+     * @brief
+     * manipulator to print integers decimal
+     */
+    inline constexpr _setbase_dec dec = {};
+
+    /**
+     * @brief
+     * character output stream on stdout
+     */
+    class ostream {
+    private:
+        /**
+         * @brief
+         * boolean that's true if integers are printed hexadecimal
+         */
+        bool hexadecimal = false;
+
+    public:
+        ostream &operator<<(char c) {
+            std::putchar(c);
+            return *this;
+        }
+
+        ostream &operator<<(const char *s) {
+            std::fputs(s, stdout);
+            return *this;
+        }
+
+        ostream &operator<<(bool b) {
+            return *this << (b ? "true" : "false");
+        }
+
+        ostream &operator<<(double d) {
+            std::printf("%g", d);
+            return *this;
+        }
+
+        ostream &operator<<(_setbase_hex) {
+            hexadecimal = true;
+            return *this;
+        }
+
+        ostream &operator<<(_setbase_dec) {
+            hexadecimal = false;
+            return *this;
+        }
+
+        template<typename T, typename = std::enable_if_t<std::is_integral_v<T> and
+                                                         not std::is_same_v<T, bool> and not std::is_same_v<T, char>>>
+        ostream &operator<<(T v) {
+            if (hexadecimal) {
+                std::printf("%llx", static_cast<unsigned long long>(v));
+            } else if (std::is_signed_v<T>) {
+                std::printf("%lld", static_cast<long long>(v));
+            } else {
+                std::printf("%llu", static_cast<unsigned long long>(v));
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * @brief
+     * character output stream on stdout
+     */
+    inline ostream cout;
+
+    /**
+     * @brief
+     * SPI-bus
+     */
+    class spi_bus {
+    protected:
+        /**
+         * @brief
+         * function to write and read n bytes at the same time
+         * @param n amount of bytes
+         * @param data_out the bytes to write, nullptr writes 0x00
+         * @param data_in the bytes that are read, nullptr ignores them
+         */
+        virtual void write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]) = 0;
+
+    public:
+        /**
+         * @brief
+         * SPI-transaction with one chip, the chip select is low as long as the object exists
+         */
+        class spi_transaction {
+        private:
+            /**
+             * @brief
+             * the bus of the transaction
+             */
+            spi_bus &bus;
+            /**
+             * @brief
+             * the chip select pin, active low
+             */
+            pin_out &sel;
+
+        public:
+            /**
+             * @brief
+             * constructor for spi_transaction, makes the chip select low
+             * @param bus the bus of the transaction
+             * @param sel the chip select pin
+             */
+            spi_transaction(spi_bus &bus, pin_out &sel) :
+                    bus(bus), sel(sel) {
+                sel.write(false);
+                sel.flush();
+            }
+
+            spi_transaction(const spi_transaction &) = delete;
+
+            /**
+             * @brief
+             * destructor for spi_transaction, makes the chip select high
+             */
+            ~spi_transaction() {
+                sel.write(true);
+                sel.flush();
+            }
+
+            /**
+             * @brief
+             * function to write and read n bytes at the same time
+             * @param n amount of bytes
+             * @param data_out the bytes to write, nullptr writes 0x00
+             * @param data_in the bytes that are read, nullptr ignores them
+             */
+            void write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]) {
+                bus.write_and_read(n, data_out, data_in);
+            }
+
+            /**
+             * @brief
+             * function to write n bytes
+             * @param n amount of bytes
+             * @param data the bytes
+             */
+            void write(size_t n, const uint8_t data[]) {
+                write_and_read(n, data, nullptr);
+            }
+
+            /**
+             * @brief
+             * function to write one byte
+             * @param data the byte
+             */
+            void write(uint8_t data) {
+                write_and_read(1, &data, nullptr);
+            }
+
+            /**
+             * @brief
+             * function to write a std::array of bytes
+             * @param data the bytes
+             */
+            template<size_t n>
+            void write(const std::array<uint8_t, n> &data) {
+                write_and_read(n, data.data(), nullptr);
+            }
+
+            /**
+             * @brief
+             * function to read n bytes
+             * @param n amount of bytes
+             * @param data the bytes that are read
+             */
+            void read(size_t n, uint8_t data[]) {
+                write_and_read(n, nullptr, data);
+            }
+
+            /**
+             * @brief
+             * function to read a std::array of bytes
+             * @param data the bytes that are read
+             */
+            template<size_t n>
+            void read(std::array<uint8_t, n> &data) {
+                write_and_read(n, nullptr, data.data());
+            }
+        };
+
+        /**
+         * @brief
+         * function to start a transaction
+         * @param sel the chip select pin
+         * @return spi_transaction the transaction, which ends when the object is destroyed
+         */
+        spi_transaction transaction(pin_out &sel) {
+            return spi_transaction(*this, sel);
+        }
+    };
+
+    /**
+     * @brief
+     * bit banged SPI-bus in mode 0, every bit costs 4 pin accesses of virtual time
+     */
+    class spi_bus_bit_banged_sclk_mosi_miso : public spi_bus {
+    private:
+        /**
+         * @brief
+         * the clock pin
+         */
+        pin_out &sclk;
+        /**
+         * @brief
+         * the master out slave in pin
+         */
+        pin_out &mosi;
+        /**
+         * @brief
+         * the master in slave out pin
+         */
+        pin_in &miso;
+
+    protected:
+        void write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]) override {
+            for (size_t i = 0; i < n; i++) {
+                uint8_t d = data_out == nullptr ? 0x00 : data_out[i];
+                for (uint_fast8_t j = 0; j < 8; j++) {
+                    mosi.write((d & 0x80) != 0);
+                    sclk.write(true);
+                    d <<= 1;
+                    if (miso.read()) {
+                        d |= 0x01;
+                    }
+                    sclk.write(false);
+                    host::advance_ns(4 * host::pin_access_ns);
+                }
+                if (data_in != nullptr) {
+                    data_in[i] = d;
+                }
+            }
+        }
+
+    public:
+        /**
+         * @brief
+         * constructor for spi_bus_bit_banged_sclk_mosi_miso
+         * @param sclk the clock pin
+         * @param mosi the master out slave in pin
+         * @param miso the master in slave out pin
+         */
+        spi_bus_bit_banged_sclk_mosi_miso(pin_out &sclk, pin_out &mosi, pin_in &miso) :
+                sclk(sclk), mosi(mosi), miso(miso) {}
+    };
+
+    namespace host {
+        /**
+         * @brief
+         * pin_out that records every change of the level with the virtual time
+         * @tparam capacity maximum amount of changes that are recorded
+         */
+        template<size_t capacity>
+        class pin_out_recorder : public pin_out {
+        public:
+            /**
+             * @brief
+             * Struct edge for a recorded change of the level
+             */
+            struct edge {
+                ///virtual time in ns of the change
+                uint_fast64_t time_ns;
+                ///the new level
+                bool level;
+            };
+
+        private:
+            /**
+             * @brief
+             * the recorded changes
+             */
+            std::array<edge, capacity> edges = {};
+            /**
+             * @brief
+             * amount of recorded changes
+             */
+            size_t amount = 0;
+            /**
+             * @brief
+             * the current level
+             */
+            bool current = false;
+            /**
+             * @brief
+             * amount of writes, including writes that don't change the level
+             */
+            uint32_t writes = 0;
+
+        public:
+            void write(bool v) override {
+                advance_ns(pin_access_ns);
+                writes++;
+                if ((amount == 0 or v != current) and amount < capacity) {
+                    edges[amount] = {clock_ns, v};
+                    amount++;
+                }
+                current = v;
+            }
+
+            /**
+             * @brief
+             * function to get a recorded change
+             * @param index index of the change, 0 is the first
+             * @return edge the change
+             */
+            edge operator[](size_t index) const {
+                return edges[index];
+            }
+
+            /**
+             * @brief
+             * function to get the amount of recorded changes
+             * @return size_t amount of changes
+             */
+            size_t size() const {
+                return amount;
+            }
+
+            /**
+             * @brief
+             * function to get the current level
+             * @return bool the level
+             */
+            bool level() const {
+                return current;
+            }
+
+            /**
+             * @brief
+             * function to get the amount of writes, including writes that don't change the level
+             * @return uint32_t amount of writes
+             */
+            uint32_t write_count() const {
+                return writes;
+            }
+
+            /**
+             * @brief
+             * function to remove all recorded changes
+             */
+            void clear() {
+                amount = 0;
+                writes = 0;
+            }
+        };
+
+        /**
+         * @brief
+         * pin_in that replays a recorded signal on the virtual clock
+         * @tparam capacity maximum amount of changes in the signal
+         */
+        template<size_t capacity>
+        class pin_in_replay : public pin_in {
+        private:
+            /**
+             * @brief
+             * virtual time in ns of every change
+             */
+            std::array<uint_fast64_t, capacity> times = {};
+            /**
+             * @brief
+             * the level after every change
+             */
+            std::array<bool, capacity> levels = {};
+            /**
+             * @brief
+             * amount of changes
+             */
+            size_t amount = 0;
+            /**
+             * @brief
+             * the level before the first change
+             */
+            bool initial;
+            /**
+             * @brief
+             * amount of reads
+             */
+            uint32_t reads = 0;
+
+        public:
+            /**
+             * @brief
+             * constructor for pin_in_replay
+             * @param initial the level before the first change
+             */
+            explicit pin_in_replay(bool initial = false) :
+                    initial(initial) {}
+
+            /**
+             * @brief
+             * function to add a change to the signal, changes are added in order of time
+             * @param time_ns virtual time in ns of the change
+             * @param level the new level
+             */
+            void add(uint_fast64_t time_ns, bool level) {
+                if (amount < capacity) {
+                    times[amount] = time_ns;
+                    levels[amount] = level;
+                    amount++;
+                }
+            }
+
+            /**
+             * @brief
+             * function to add a pulse to the signal
+             * @param start_ns virtual time in ns of the start of the pulse
+             * @param length_ns length of the pulse in ns
+             * @param level the level during the pulse
+             */
+            void pulse(uint_fast64_t start_ns, uint_fast64_t length_ns, bool level = true) {
+                add(start_ns, level);
+                add(start_ns + length_ns, not level);
+            }
+
+            bool read() override {
+                advance_ns(pin_access_ns);
+                reads++;
+                bool level = initial;
+                for (size_t i = 0; i < amount and times[i] <= clock_ns; i++) {
+                    level = levels[i];
+                }
+                return level;
+            }
+
+            /**
+             * @brief
+             * function to get the amount of reads
+             * @return uint32_t amount of reads
+             */
+            uint32_t read_count() const {
+                return reads;
+            }
+
+            /**
+             * @brief
+             * function to remove the signal
+             */
+            void clear() {
+                amount = 0;
+                reads = 0;
+            }
+        };
+
+        /**
+         * @brief
+         * SPI-bus that records the written bytes and replays prepared bytes on the read side
+         * @details
+         * The time of a byte is the same as on the bit banged bus. Bytes that are read when no prepared bytes are left
+         * are 0x00.
+         * @tparam capacity maximum amount of recorded and prepared bytes
+         */
+        template<size_t capacity>
+        class spi_bus_recorder : public spi_bus {
+        private:
+            /**
+             * @brief
+             * the written bytes
+             */
+            std::array<uint8_t, capacity> written = {};
+            /**
+             * @brief
+             * amount of written bytes
+             */
+            size_t written_amount = 0;
+            /**
+             * @brief
+             * the prepared bytes for the read side
+             */
+            std::array<uint8_t, capacity> replies = {};
+            /**
+             * @brief
+             * amount of prepared bytes
+             */
+            size_t reply_amount = 0;
+            /**
+             * @brief
+             * index of the next prepared byte
+             */
+            size_t reply_index = 0;
+            /**
+             * @brief
+             * amount of calls of write_and_read()
+             */
+            uint32_t calls = 0;
+
+        protected:
+            void write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]) override {
+                calls++;
+                for (size_t i = 0; i < n; i++) {
+                    advance_ns(32 * pin_access_ns);
+                    if (written_amount < capacity) {
+                        written[written_amount] = data_out == nullptr ? 0x00 : data_out[i];
+                        written_amount++;
+                    }
+                    uint8_t reply = 0x00;
+                    if (reply_index < reply_amount) {
+                        reply = replies[reply_index];
+                        reply_index++;
+                    }
+                    if (data_in != nullptr) {
+                        data_in[i] = reply;
+                    }
+                }
+            }
+
+        public:
+            /**
+             * @brief
+             * function to add a byte to the read side
+             * @param byte the byte
+             */
+            void reply(uint8_t byte) {
+                if (reply_amount < capacity) {
+                    replies[reply_amount] = byte;
+                    reply_amount++;
+                }
+            }
+
+            /**
+             * @brief
+             * function to get a written byte
+             * @param index index of the byte, 0 is the first
+             * @return uint8_t the byte
+             */
+            uint8_t operator[](size_t index) const {
+                return written[index];
+            }
+
+            /**
+             * @brief
+             * function to get the amount of written bytes
+             * @return size_t amount of bytes
+             */
+            size_t size() const {
+                return written_amount;
+            }
+
+            /**
+             * @brief
+             * function to get the amount of calls of write_and_read()
+             * @return uint32_t amount of calls
+             */
+            uint32_t call_count() const {
+                return calls;
+            }
+
+            /**
+             * @brief
+             * function to remove the written and prepared bytes
+             */
+            void clear() {
+                written_amount = 0;
+                reply_amount = 0;
+                reply_index = 0;
+                calls = 0;
+            }
+        };
+    } //namespace host
+} //namespace hwlib
+#endif //IPASS_HOST_HWLIB_H
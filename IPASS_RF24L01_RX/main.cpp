@@ -1,6 +1,67 @@
-#include "../Libraries/RF24L01/RF24L01.hpp"
+#include "../Libraries/RF24L01/RF24L01_RX_Engine.hpp"
+#include "../Libraries/RF24L01/RF24L01_Config.hpp"
 #include "../Libraries/APA102/APA102.hpp"
+#include "../Libraries/Deadline_Scheduler/Deadline_Scheduler.hpp"
 
+//std::array containing the ADDRESS
+static constexpr std::array<uint8_t, 5> address = {0xe7, 0xe7, 0xe7, 0xe7, 0xe7};
+
+//Configuration of the RF24L01: channel 0x11, 1 Mbps and packagesize 5 on pipe 0, checked at compile time
+static constexpr IPASS::RF24L01_Config radio_config = IPASS::RF24L01_Config()
+        .rx_address(0, address)
+        .tx_address(address)
+        .channel(0x11)
+        .data_rate_2mbps(false)
+        .pipe(0, true, 5)
+        .pipe(1, false, 0);
+
+//State of the tasks of the scheduler
+struct receiver_tasks {
+    IPASS::Deadline_Scheduler<3> &loop;
+    IPASS::RF24L01_RX_Engine<5, 8> &receiver;
+    IPASS::APA102 &ledstrip;
+    hwlib::pin_out &led;
+    //id of the refresh task, triggered by a received color
+    size_t refresh;
+    //id of the animation task, runs while the random color command is active
+    size_t animate;
+    //the last received payload
+    std::array<uint8_t, 5> data;
+    uint8_t counter;
+};
+
+//Task every 250 us: handle all received packets, costs no SPI-transaction while the IRQ-pin is high
+static void poll_radio(void *context) {
+    receiver_tasks &tasks = *static_cast<receiver_tasks *>(context);
+    tasks.receiver.poll();
+    IPASS::RF24L01_RX_Engine<5, 8>::packet packet_in = {};
+    while (tasks.receiver.pop(packet_in)) {
+        tasks.led.write(1);
+        tasks.data = packet_in.data;
+        if (packet_in.data[4] == 0xff) {
+            tasks.counter = 0;
+            tasks.loop.trigger(tasks.animate);
+        } else {
+            tasks.loop.cancel(tasks.animate);
+            tasks.loop.trigger(tasks.refresh);
+        }
+    }
+}
+
+//Event task: write the received color to the APA102
+static void refresh_leds(void *context) {
+    receiver_tasks &tasks = *static_cast<receiver_tasks *>(context);
+    tasks.ledstrip.write({tasks.data[0], tasks.data[1], tasks.data[2]}, tasks.data[3]);
+}
+
+//Task every 100 ms after the random color command: new random colors every 7 runs
+static void animate_leds(void *context) {
+    receiver_tasks &tasks = *static_cast<receiver_tasks *>(context);
+    if (tasks.counter % 7 == 0) {
+        tasks.ledstrip.random_colors();
+    }
+    tasks.counter++;
+}
 
 int main() {
     //Kill the watchdog
@@ -27,42 +88,26 @@ int main() {
     auto spi_bus2 = hwlib::spi_bus_bit_banged_sclk_mosi_miso(clk2, mosi2, hwlib::pin_in_dummy);
     auto ledstrip = IPASS::APA102(spi_bus2);
 
-    const std::array<uint8_t, 5> address = {0xe7, 0xe7, 0xe7, 0xe7, 0xe7};
-    IPASS::RF24L01 chip(spi_bus, RX_TX, minion_select, IRQ, address, address, 0x11, false);
+    IPASS::RF24L01 chip(spi_bus, RX_TX, minion_select, IRQ);
+    //Write the configuration with one SPI-transaction per register
+    chip.apply<radio_config>();
 
-    //Set packagesize of pipe 0 to 5
-    chip.change_RX_PW_P(0, 5);
+    //Keep a copy of the configuration registers so settings only cost one SPI-transaction
+    chip.use_shadow_registers();
 
     hwlib::wait_ms(200);
 
     //Enable RX mode on RF24L01
     chip.start_RX();
-    std::array<uint8_t, 5> data_in = {0x00, 0x00, 0x00, 0x00};
-    bool random_color = false;
-    uint8_t counter = 0;
-    for (;;) {
-
-        //check if packet is recieved
-        if (chip.packet_received()) {
-            led.write(1);
-            //read rx_data to data in;
-            chip.read_rx(data_in);
-            if(data_in[4] == 0xff){
-                random_color=true;
-            }
-            else {
-                random_color = false;
-                counter=0;
-                //write recieved data to the APA102
-                ledstrip.write({data_in[0], data_in[1], data_in[2]}, data_in[3]);
-            }
-        }
-        if(random_color){
-            if(counter%7==0){
-                ledstrip.random_colors();
-            }
-            counter++;
-        }
-        hwlib::wait_ms(100);
-    }
+    //Receiver that empties the RX FIFO into a buffer of 8 packets when the IRQ-pin goes low
+    IPASS::RF24L01_RX_Engine<5, 8> receiver(chip);
+
+    //A received color is on the APA102 within 250 us, between the tasks the scheduler waits until the next deadline
+    IPASS::Deadline_Scheduler<3> loop;
+    receiver_tasks tasks = {loop, receiver, ledstrip, led, 0, 0, {}, 0};
+    tasks.refresh = loop.add_event(refresh_leds, &tasks);
+    tasks.animate = loop.add(animate_leds, &tasks, 100'000);
+    loop.cancel(tasks.animate);
+    loop.add(poll_radio, &tasks, 250);
+    loop.run();
 }
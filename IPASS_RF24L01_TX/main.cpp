@@ -1,5 +1,56 @@
-#include "../Libraries/RF24L01/RF24L01.hpp"
+#include "../Libraries/RF24L01/RF24L01_Async_TX.hpp"
+#include "../Libraries/RF24L01/RF24L01_Config.hpp"
+#include "../Libraries/Deadline_Scheduler/Deadline_Scheduler.hpp"
 
+//std::array containing the ADDRESS
+static constexpr std::array<uint8_t, 5> address = {0xe7, 0xe7, 0xe7, 0xe7, 0xe7};
+
+//Configuration of the RF24L01: channel 0x11, 1 Mbps and packagesize 5 on pipe 0, checked at compile time
+static constexpr IPASS::RF24L01_Config radio_config = IPASS::RF24L01_Config()
+        .rx_address(0, address)
+        .tx_address(address)
+        .channel(0x11)
+        .data_rate_2mbps(false)
+        .pipe(0, true, 5)
+        .pipe(1, false, 0);
+
+//Inputs and transmitter of the tasks of the scheduler
+struct transmitter_tasks {
+    IPASS::RF24L01_Async_TX<5, 4> &transmitter;
+    hwlib::pin_in &send_value;
+    hwlib::pin_in &turn_off;
+    hwlib::pin_in &random_color;
+    std::array<hwlib::adc *, 4> potentiometers;
+    //level of the buttons at the previous scan, a press is send once
+    bool pressed;
+};
+
+//Task every 1 ms: send the RGB and brightness values, {0,0,0,0} or a random color command when a button is pressed
+static void scan_buttons(void *context) {
+    transmitter_tasks &tasks = *static_cast<transmitter_tasks *>(context);
+    bool send_value = tasks.send_value.read();
+    bool turn_off = not send_value and tasks.turn_off.read();
+    bool random_color = not send_value and not turn_off and tasks.random_color.read();
+    bool pressed = send_value or turn_off or random_color;
+    if (pressed and not tasks.pressed) {
+        //data[0] is send first, the receiver reads it in the last element of its std::array
+        uint8_t data[5] = {};
+        if (send_value) {
+            for (size_t i = 0; i < tasks.potentiometers.size(); i++) {
+                data[4 - i] = tasks.potentiometers[i]->read();
+            }
+        } else if (random_color) {
+            data[0] = 0xff;
+        }
+        tasks.transmitter.submit(data, 5);
+    }
+    tasks.pressed = pressed;
+}
+
+//Task every 250 us: handle TX_DS and MAX_RT, costs no SPI-transaction while the IRQ-pin is high
+static void poll_radio(void *context) {
+    static_cast<transmitter_tasks *>(context)->transmitter.poll();
+}
 
 int main() {
     //Kill the watchdog
@@ -27,41 +78,21 @@ int main() {
     auto Turn_off_button = hwlib::target::pin_in(hwlib::target::pins::d11);
     auto Random_color_button = hwlib::target::pin_in(hwlib::target::pins::d13);
 
-    //std::array containing the ADDRESS
-    const std::array<uint8_t, 5> address = {0xe7, 0xe7, 0xe7, 0xe7, 0xe7};
-    IPASS::RF24L01 chip(spi_bus, RX_TX, minion_select, IRQ, address, address, 0x11, false);
+    IPASS::RF24L01 chip(spi_bus, RX_TX, minion_select, IRQ);
+    //Write the configuration with one SPI-transaction per register
+    chip.apply<radio_config>();
 
-    std::array<uint8_t, 5> data={};
-    for(;;) {
-        //If send_value_button pressed read data from potentiometers and send them
-        if(Send_value_button.read()){
-            data[0]=red.read();
-            data[1]=green.read();
-            data[2]=blue.read();
-            data[3]=brightness.read();
-            data[4]=0x00;
-            chip.write_tx(data);
-            chip.send_packages();
-            while(Send_value_button.read()){
-                hwlib::wait_us(1);
-            };
-        }
-        //If Turn_off_button pressed write {0,0,0,0}
-        if(Turn_off_button.read()){
-            data = {0x00,0x00,0x00,0x00, 0x00};
-            chip.write_tx(data);
-            chip.send_packages();
-            while(Turn_off_button.read()){
-                hwlib::wait_us(1);
-            }
-        }
-        if(Random_color_button.read()){
-            data = {0x00, 0x00, 0x00, 0x00, 0xff};
-            chip.write_tx(data);
-            chip.send_packages();
-            while(Random_color_button.read()){
-                hwlib::wait_us(1);
-            }
-        }
-    }
-}
\ No newline at end of file
+    //Keep a copy of the configuration registers so settings only cost one SPI-transaction
+    chip.use_shadow_registers();
+
+    //Transmitter that sends a payload without waiting for the acknowledgement
+    IPASS::RF24L01_Async_TX<5, 4> transmitter(chip);
+    transmitter_tasks tasks = {transmitter, Send_value_button, Turn_off_button, Random_color_button,
+                               {&red, &green, &blue, &brightness}, false};
+
+    //A press is send within 1 ms, between the tasks the scheduler waits until the next deadline
+    IPASS::Deadline_Scheduler<2> loop;
+    loop.add(scan_buttons, &tasks, 1'000);
+    loop.add(poll_radio, &tasks, 250);
+    loop.run();
+}
@@ -1,10 +1,13 @@
 #include "APA102.hpp"
 namespace IPASS {
-    APA102::APA102(hwlib::spi_bus_bit_banged_sclk_mosi_miso &SPI_bus, uint8_t amount_of_leds) :
+    APA102::APA102(hwlib::spi_bus &SPI_bus, uint8_t amount_of_leds) :
             SPI_bus(SPI_bus),
             amount_of_leds(amount_of_leds){}
 
     void APA102::write(color kleur, uint8_t brightness) {
+#ifdef IPASS_LATENCY
+        IPASS_LATENCY_SCOPE(write_us);
+#endif
         auto transaction = SPI_bus.transaction(hwlib::pin_out_dummy);
         std::array<uint8_t, 40> data = {0x00, 0x00, 0x00, 0x00};
         brightness >>=3;
@@ -26,4 +29,15 @@ namespace IPASS {
         color Temp = {static_cast<uint8_t>(hwlib::rand() & 0xFF), static_cast<uint8_t>((hwlib::rand() & 0xFF00) >> 8), static_cast<uint8_t>((hwlib::rand() & 0xFF0000) >> 16)};
         write(Temp, static_cast<uint8_t>(hwlib::rand() & 0xFF));
     }
-}
\ No newline at end of file
+
+#ifdef IPASS_LATENCY
+    const Latency_Histogram<> &APA102::latency() const {
+        return write_us;
+    }
+
+    void APA102::print_latency(hwlib::ostream &out) const {
+        Latency_Histogram<>::print_header(out);
+        write_us.print("APA102 write", out);
+    }
+#endif
+}
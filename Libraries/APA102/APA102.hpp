@@ -6,6 +6,8 @@
 #include "hwlib.hpp"
 #endif //HWLIB_INC_HPP
 
+#include "../Latency_Histogram/Latency_Histogram.hpp"
+
 /** @file APA102.hpp
  *  @brief
  *  IPASS-project: Limited interface for the APA102 LED strip
@@ -21,14 +23,21 @@ namespace IPASS {
     private:
         /**
          * @brief
-         * Bit banged spi bus object used to write data to the APA102
+         * spi bus object used to write data to the APA102, bit banged or a hardware SPI-bus of the target
          */
-        hwlib::spi_bus_bit_banged_sclk_mosi_miso &SPI_bus;
+        hwlib::spi_bus &SPI_bus;
         /**
          * @brief
          * Variable that contains the amount of leds on the strip
          */
         uint8_t amount_of_leds;
+#ifdef IPASS_LATENCY
+        /**
+         * @brief
+         * time in us of the calls of write()
+         */
+        Latency_Histogram<> write_us;
+#endif //IPASS_LATENCY
     public:
         /**
          * @brief
@@ -97,11 +106,11 @@ namespace IPASS {
          * @brief
          * Default constructor APA102
          * @details
-         * constructor that takes a spi_bus and a uint8_t as parameters
+         * constructor that takes a spi_bus and a uint8_t as parameters, any hwlib::spi_bus works
          * @param SPI_bus SPI_BUS used to communicate with the LED
          * @param amount_of_leds UINT8_T used to determine how much leds need to be written default value = 8
          */
-        APA102(hwlib::spi_bus_bit_banged_sclk_mosi_miso &SPI_bus, uint8_t amount_of_leds=8);
+        APA102(hwlib::spi_bus &SPI_bus, uint8_t amount_of_leds=8);
 
         /**
          * @brief
@@ -112,8 +121,11 @@ namespace IPASS {
          */
         template<size_t template_amount_of_leds>
         void write(std::array<std::array<uint8_t, 3>, template_amount_of_leds> colors, uint8_t brightness = 0x1f) {
+#ifdef IPASS_LATENCY
+            IPASS_LATENCY_SCOPE(write_us);
+#endif
             auto transaction = SPI_bus.transaction(hwlib::pin_out_dummy);
-            std::array<uint8_t, template_amount_of_leds*2+8> data = {0x00, 0x00, 0x00, 0x00};
+            std::array<uint8_t, template_amount_of_leds*4+8> data = {0x00, 0x00, 0x00, 0x00};
             brightness >>=3;
             for (unsigned int i = 0; i < template_amount_of_leds; i++) {
                 data[4 + i * 4] = (brightness | 0xe0);
@@ -122,10 +134,10 @@ namespace IPASS {
                 data[4 + i * 4 + 3] = colors[i][0];
 
             }
-            data[4 + amount_of_leds * 4] = 0xff;
-            data[4 + amount_of_leds * 4 + 1] = 0xFF;
-            data[4 + amount_of_leds * 4 + 2] = 0xFF;
-            data[4 + amount_of_leds * 4 + 3] = 0xFF;
+            data[4 + template_amount_of_leds * 4] = 0xff;
+            data[4 + template_amount_of_leds * 4 + 1] = 0xFF;
+            data[4 + template_amount_of_leds * 4 + 2] = 0xFF;
+            data[4 + template_amount_of_leds * 4 + 3] = 0xFF;
             transaction.write(data);
         }
         /**
@@ -141,6 +153,22 @@ namespace IPASS {
          */
         void random_colors();
 
+#ifdef IPASS_LATENCY
+        /**
+         * @brief
+         * function to get the time of the calls of write(), only with IPASS_LATENCY
+         * @return Latency_Histogram with the times in us since the construction
+         */
+        const Latency_Histogram<> &latency() const;
+
+        /**
+         * @brief
+         * function to print the histogram of latency() with a header
+         * @param out the stream to print to, default value = hwlib::cout
+         */
+        void print_latency(hwlib::ostream &out = hwlib::cout) const;
+#endif //IPASS_LATENCY
+
     };
 }
 
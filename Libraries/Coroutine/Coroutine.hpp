@@ -0,0 +1,447 @@
+//======================================================================================================================
+/**
+ *  @file      Coroutine.hpp
+ *  @brief     IPASS-project: Allocation-free C++20 coroutines with a cooperative scheduler for one core.
+ */
+//======================================================================================================================
+#ifndef IPASS_COROUTINE_H
+#define IPASS_COROUTINE_H
+
+#include "hwlib.hpp"
+#include <array>
+#include <cstddef>
+
+// GCC 10 only compiles coroutines with -fcoroutines, GCC 11 and later with -std=c++20
+#if defined(__GNUC__) and not defined(__clang__) and not defined(__cpp_impl_coroutine)
+#error "Coroutine.hpp needs -std=c++20, and -fcoroutines with GCC 10"
+#endif
+#include <coroutine>
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Coroutine that's run by a Coroutine_Scheduler
+     * @details
+     * The frames of the coroutines of one Coroutine_Task type come from a static pool of frames, so a coroutine never
+     * uses the heap. When the pool is empty or a frame doesn't fit, the coroutine is not created and valid() is false.
+     * The size of a frame depends on the parameters and the local variables that live across a co_await, so check
+     * valid() or the result of Coroutine_Scheduler::spawn(). Every frame starts at a multiple of
+     * alignof(std::max_align_t), whatever frame_size is. Needs -std=c++20, also for the Due (CPP_LANGUAGE in the
+     * project makefile), and -fcoroutines with GCC 10. A coroutine is started by the scheduler:
+     * @code
+     * IPASS::Coroutine_Task<> blink(IPASS::Coroutine_Scheduler<> &loop, hwlib::pin_out &led) {
+     *     for (;;) {
+     *         led.write(true);
+     *         co_await loop.sleep_us(500'000);
+     *         led.write(false);
+     *         co_await loop.sleep_us(500'000);
+     *     }
+     * }
+     * loop.spawn(blink(loop, led));
+     * loop.run();
+     * @endcode
+     * @tparam frame_size the size in bytes of a frame of the pool
+     * @tparam frames the amount of frames in the pool, 1-32
+     */
+    template<size_t frame_size = 256, size_t frames = 8>
+    class Coroutine_Task {
+        static_assert(frames > 0 and frames <= 32, "the frame pool has 1-32 frames");
+    public:
+        /**
+         * @brief
+         * Promise of the coroutine, allocates the frame from the pool
+         */
+        struct promise_type {
+            /**
+             * @brief
+             * storage of one frame, its size is rounded up to a multiple of the alignment so the next frame is aligned
+             */
+            struct alignas(std::max_align_t) frame_storage {
+                ///the bytes of the frame
+                uint8_t bytes[frame_size];
+            };
+            static_assert(sizeof(frame_storage) % alignof(std::max_align_t) == 0, "every frame of the pool is aligned");
+
+            /**
+             * @brief
+             * storage of the frames
+             */
+            static inline std::array<frame_storage, frames> pool = {};
+            /**
+             * @brief
+             * bitmask with a bit per frame that's in use
+             */
+            static inline uint32_t used = 0;
+
+            /**
+             * @brief
+             * function to allocate a frame from the pool
+             * @param size the size of the frame the compiler needs
+             * @return pointer to a free frame, nullptr if the frame doesn't fit or the pool is empty
+             */
+            static void *operator new(size_t size) noexcept {
+                if (size > frame_size) {
+                    return nullptr;
+                }
+                for (size_t i = 0; i < frames; i++) {
+                    if (not(used & (1UL << i))) {
+                        used |= (1UL << i);
+                        return pool[i].bytes;
+                    }
+                }
+                return nullptr;
+            }
+
+            /**
+             * @brief
+             * function to give a frame back to the pool
+             * @param frame the frame
+             */
+            static void operator delete(void *frame) noexcept {
+                for (size_t i = 0; i < frames; i++) {
+                    if (frame == pool[i].bytes) {
+                        used &= ~(1UL << i);
+                    }
+                }
+            }
+
+            /**
+             * @brief
+             * function to get the amount of frames in use
+             * @return size_t amount of coroutines of this type that exist
+             */
+            static size_t frames_used() {
+                size_t count = 0;
+                for (size_t i = 0; i < frames; i++) {
+                    count += (used >> i) & 1;
+                }
+                return count;
+            }
+
+            ///called by the compiler when operator new returns nullptr
+            static Coroutine_Task get_return_object_on_allocation_failure() {
+                return Coroutine_Task(nullptr);
+            }
+
+            ///called by the compiler to make the Coroutine_Task
+            Coroutine_Task get_return_object() {
+                return Coroutine_Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            ///the coroutine waits for the scheduler before it starts
+            std::suspend_always initial_suspend() noexcept {
+                return {};
+            }
+
+            ///the frame stays until the scheduler sees that the coroutine is done
+            std::suspend_always final_suspend() noexcept {
+                return {};
+            }
+
+            ///a coroutine of a Coroutine_Task returns nothing
+            void return_void() {}
+
+            ///the targets are build without exceptions
+            void unhandled_exception() {}
+        };
+
+    private:
+        /**
+         * @brief
+         * the coroutine, nullptr after the move to a scheduler
+         */
+        std::coroutine_handle<promise_type> handle;
+
+        /**
+         * @brief
+         * constructor for the Coroutine_Task, only used by promise_type
+         * @param handle the coroutine
+         */
+        explicit Coroutine_Task(std::coroutine_handle<promise_type> handle) :
+                handle(handle) {}
+
+    public:
+        Coroutine_Task(const Coroutine_Task &) = delete;
+
+        Coroutine_Task &operator=(const Coroutine_Task &) = delete;
+
+        /**
+         * @brief
+         * move constructor, the coroutine belongs to the new Coroutine_Task
+         * @param other the Coroutine_Task that gives up the coroutine
+         */
+        Coroutine_Task(Coroutine_Task &&other) noexcept :
+                handle(other.handle) {
+            other.handle = nullptr;
+        }
+
+        /**
+         * @brief
+         * destructor, destroys the coroutine if it's not given to a scheduler
+         */
+        ~Coroutine_Task() {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        /**
+         * @brief
+         * function to check if the coroutine is created
+         * @return boolean that's false if there was no frame for the coroutine
+         */
+        bool valid() const {
+            return bool(handle);
+        }
+
+        /**
+         * @brief
+         * function to give up the coroutine, used by Coroutine_Scheduler::spawn()
+         * @return std::coroutine_handle<> the coroutine
+         */
+        std::coroutine_handle<> release() {
+            std::coroutine_handle<> result = handle;
+            handle = nullptr;
+            return result;
+        }
+    };
+
+    /**
+     * @brief
+     * Cooperative scheduler that runs coroutines on one core
+     * @details
+     * Every coroutine has a slot with the time it's due. co_await sleep_us() sets that time, co_await yield() makes
+     * the coroutine due directly and an awaiter of a driver marks the slot as waiting until wake() is called, for
+     * example from a callback. The pollers of the drivers run once per round, before the due coroutines are resumed.
+     * A coroutine is only resumed by the scheduler, never from a callback, so a callback can't run coroutine code in
+     * the middle of a driver function. When no coroutine is due the scheduler waits until the first sleeping coroutine
+     * is due, at most idle_us so the pollers keep running.
+     * @tparam capacity the amount of coroutines that can run at the same time
+     * @tparam pollers the amount of pollers that can be added
+     */
+    template<size_t capacity = 8, size_t pollers = 4>
+    class Coroutine_Scheduler {
+    private:
+        /**
+         * @brief
+         * Struct slot that contains a coroutine of the scheduler
+         */
+        struct slot {
+            ///the coroutine, nullptr if the slot is free
+            std::coroutine_handle<> handle;
+            ///time in us at which the coroutine is due
+            uint_fast64_t due;
+            ///boolean that's true while the coroutine waits for wake()
+            bool waiting;
+        };
+
+        /**
+         * @brief
+         * Struct poller that contains a function of a driver that's called every round
+         */
+        struct poller {
+            ///the function, nullptr if the poller is free
+            void (*function)(void *context);
+            ///parameter of function
+            void *context;
+        };
+
+        /**
+         * @brief
+         * the coroutines
+         */
+        std::array<slot, capacity> slots = {};
+        /**
+         * @brief
+         * the pollers
+         */
+        std::array<poller, pollers> poll_functions = {};
+        /**
+         * @brief
+         * index of the slot of the coroutine that's running
+         */
+        size_t current = 0;
+        /**
+         * @brief
+         * maximum time in us the scheduler waits when no coroutine is due
+         */
+        uint32_t idle_us;
+
+    public:
+        /**
+         * @brief
+         * Awaiter of sleep_us() and yield()
+         */
+        struct sleep_awaiter {
+            ///the scheduler
+            Coroutine_Scheduler &scheduler;
+            ///time in us at which the coroutine is due again
+            uint_fast64_t due;
+
+            ///a sleep always suspends, so the other coroutines get a turn
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            ///sets the time at which the coroutine is due
+            void await_suspend(std::coroutine_handle<>) noexcept {
+                scheduler.slots[scheduler.current].due = due;
+            }
+
+            ///a sleep returns nothing
+            void await_resume() const noexcept {}
+        };
+
+        /**
+         * @brief
+         * constructor for the Coroutine_Scheduler
+         * @param idle_us maximum time in us the scheduler waits when no coroutine is due, default value = 10
+         */
+        explicit Coroutine_Scheduler(uint32_t idle_us = 10) :
+                idle_us(idle_us) {}
+
+        /**
+         * @brief
+         * function to add a coroutine
+         * @param task the coroutine, it starts in the next round
+         * @return boolean that's false if the task is not valid or all slots are used
+         */
+        template<size_t frame_size, size_t frames>
+        bool spawn(Coroutine_Task<frame_size, frames> &&task) {
+            if (not task.valid()) {
+                return false;
+            }
+            for (slot &s : slots) {
+                if (not s.handle) {
+                    s = {task.release(), 0, false};
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief
+         * function to add a function of a driver that's called every round
+         * @param function the function
+         * @param context parameter of function
+         * @return boolean that's false if all pollers are used
+         */
+        bool add_poller(void (*function)(void *context), void *context) {
+            for (poller &p : poll_functions) {
+                if (p.function == nullptr) {
+                    p = {function, context};
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief
+         * function for an awaiter to suspend the running coroutine until wake()
+         * @return std::coroutine_handle<> the running coroutine, the parameter of wake()
+         */
+        std::coroutine_handle<> wait() {
+            slots[current].waiting = true;
+            return slots[current].handle;
+        }
+
+        /**
+         * @brief
+         * function to make a waiting coroutine due, can be called from a callback of a poller
+         * @param handle the coroutine returned by wait()
+         */
+        void wake(std::coroutine_handle<> handle) {
+            for (slot &s : slots) {
+                if (s.handle == handle) {
+                    s.waiting = false;
+                    s.due = 0;
+                }
+            }
+        }
+
+        /**
+         * @brief
+         * function to suspend the running coroutine for a time
+         * @param us the time in us
+         * @return sleep_awaiter for co_await
+         */
+        sleep_awaiter sleep_us(uint_fast64_t us) {
+            return {*this, hwlib::now_us() + us};
+        }
+
+        /**
+         * @brief
+         * function to give the other coroutines a turn
+         * @return sleep_awaiter for co_await
+         */
+        sleep_awaiter yield() {
+            return {*this, 0};
+        }
+
+        /**
+         * @brief
+         * function to get the amount of coroutines that are not done
+         * @return size_t amount of coroutines
+         */
+        size_t tasks() const {
+            size_t count = 0;
+            for (const slot &s : slots) {
+                count += bool(s.handle);
+            }
+            return count;
+        }
+
+        /**
+         * @brief
+         * function to run one round: the pollers and every coroutine that's due
+         * @return boolean that's true if a coroutine was resumed
+         */
+        bool run_once() {
+            for (const poller &p : poll_functions) {
+                if (p.function != nullptr) {
+                    p.function(p.context);
+                }
+            }
+            const uint_fast64_t now = hwlib::now_us();
+            bool resumed = false;
+            for (current = 0; current < capacity; current++) {
+                slot &s = slots[current];
+                if (s.handle and not s.waiting and s.due <= now) {
+                    resumed = true;
+                    s.handle.resume();
+                    if (s.handle.done()) {
+                        s.handle.destroy();
+                        s.handle = nullptr;
+                    }
+                }
+            }
+            return resumed;
+        }
+
+        /**
+         * @brief
+         * function to run rounds until all coroutines are done
+         * @details
+         * When no coroutine is due, waits until the first sleeping coroutine is due, at most idle_us
+         */
+        void run() {
+            while (tasks() > 0) {
+                if (run_once()) {
+                    continue;
+                }
+                uint_fast64_t wait = idle_us;
+                const uint_fast64_t now = hwlib::now_us();
+                for (const slot &s : slots) {
+                    if (s.handle and not s.waiting and s.due > now and s.due - now < wait) {
+                        wait = s.due - now;
+                    }
+                }
+                hwlib::wait_us(wait);
+            }
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_COROUTINE_H
@@ -0,0 +1,336 @@
+//======================================================================================================================
+/**
+ *  @file      Deadline_Scheduler.hpp
+ *  @brief     IPASS-project: Cooperative scheduler of periodic and event-triggered tasks with deadlines in us.
+ */
+//======================================================================================================================
+#ifndef IPASS_DEADLINE_SCHEDULER_H
+#define IPASS_DEADLINE_SCHEDULER_H
+
+#include "hwlib.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Cooperative scheduler that runs tasks at their deadline
+     * @details
+     * A task is a function with a context. A periodic task runs every period_us, an event task only runs after
+     * trigger(), for example from a task that polls the IRQ-pin. The scheduled tasks are kept in a min-heap on their
+     * deadline, so finding the next task is O(1) and (re)scheduling is O(log capacity), without heap allocation. When
+     * no task is due, run() waits until the first deadline instead of polling with a fixed wait. A periodic task that
+     * is late keeps its phase and skips the periods it missed, so a slow task doesn't cause a burst of runs. Tasks run
+     * to completion, keep them short: the latency of an event is at most the longest task plus the period of the task
+     * that detects it. Works with C++17, see Coroutine_Scheduler for coroutines.
+     * @code
+     * IPASS::Deadline_Scheduler<4> loop;
+     * size_t refresh = loop.add_event(write_leds, &strip);
+     * loop.add(poll_radio, &receiver, 250);
+     * loop.run();
+     * @endcode
+     * @tparam capacity the maximum amount of tasks
+     */
+    template<size_t capacity = 8>
+    class Deadline_Scheduler {
+        static_assert(capacity > 0, "a Deadline_Scheduler has at least one task");
+    public:
+        /**
+         * @brief
+         * Function of a task: function(context)
+         */
+        using function = void (*)(void *context);
+
+        /**
+         * @brief
+         * id returned by add() and add_event() when all tasks are used
+         */
+        static constexpr size_t none = capacity;
+
+    private:
+        /**
+         * @brief
+         * Struct task that contains a task of the scheduler
+         */
+        struct task {
+            ///the function, nullptr if the task is free
+            function run;
+            ///parameter of run
+            void *context;
+            ///time in us at which the task is due
+            uint_fast64_t due;
+            ///time in us between the runs, 0 for an event task
+            uint_fast64_t period_us;
+        };
+
+        /**
+         * @brief
+         * the tasks, the id of a task is its index
+         */
+        std::array<task, capacity> tasks = {};
+        /**
+         * @brief
+         * min-heap with the ids of the scheduled tasks, ordered on due
+         */
+        std::array<size_t, capacity> heap = {};
+        /**
+         * @brief
+         * index in heap of every task, none if the task is not scheduled
+         */
+        std::array<size_t, capacity> position = {};
+        /**
+         * @brief
+         * amount of scheduled tasks
+         */
+        size_t scheduled = 0;
+        /**
+         * @brief
+         * amount of runs of the tasks
+         */
+        uint32_t runs = 0;
+        /**
+         * @brief
+         * the largest time in us between the deadline and the start of a run
+         */
+        uint_fast64_t lateness_max = 0;
+
+        /**
+         * @brief
+         * function to swap two elements of the heap
+         * @param a index in heap
+         * @param b index in heap
+         */
+        void swap(size_t a, size_t b) {
+            size_t id = heap[a];
+            heap[a] = heap[b];
+            heap[b] = id;
+            position[heap[a]] = a;
+            position[heap[b]] = b;
+        }
+
+        /**
+         * @brief
+         * function to restore the heap after the deadline of an element changed
+         * @param index index in heap of the element
+         */
+        void sift(size_t index) {
+            while (index > 0 and tasks[heap[index]].due < tasks[heap[(index - 1) / 2]].due) {
+                swap(index, (index - 1) / 2);
+                index = (index - 1) / 2;
+            }
+            for (;;) {
+                size_t smallest = index;
+                for (size_t child = index * 2 + 1; child <= index * 2 + 2 and child < scheduled; child++) {
+                    if (tasks[heap[child]].due < tasks[heap[smallest]].due) {
+                        smallest = child;
+                    }
+                }
+                if (smallest == index) {
+                    return;
+                }
+                swap(index, smallest);
+                index = smallest;
+            }
+        }
+
+        /**
+         * @brief
+         * function to set the deadline of a task and (re)schedule it
+         * @param id the task
+         * @param due time in us at which the task is due
+         */
+        void schedule(size_t id, uint_fast64_t due) {
+            tasks[id].due = due;
+            if (position[id] == none) {
+                heap[scheduled] = id;
+                position[id] = scheduled;
+                scheduled++;
+            }
+            sift(position[id]);
+        }
+
+    public:
+        /**
+         * @brief
+         * constructor for the Deadline_Scheduler
+         */
+        Deadline_Scheduler() {
+            position.fill(none);
+        }
+
+        /**
+         * @brief
+         * function to add a periodic task
+         * @param run the function of the task
+         * @param context parameter of run
+         * @param period_us time in us between the runs, more than 0
+         * @param delay_us time in us until the first run, default value = 0
+         * @return size_t id of the task, none if all tasks are used
+         */
+        size_t add(function run, void *context, uint_fast64_t period_us, uint_fast64_t delay_us = 0) {
+            size_t id = add_event(run, context);
+            if (id != none) {
+                tasks[id].period_us = period_us;
+                schedule(id, hwlib::now_us() + delay_us);
+            }
+            return id;
+        }
+
+        /**
+         * @brief
+         * function to add an event task, which runs once per trigger()
+         * @param run the function of the task
+         * @param context parameter of run
+         * @return size_t id of the task, none if all tasks are used
+         */
+        size_t add_event(function run, void *context) {
+            for (size_t id = 0; id < capacity; id++) {
+                if (tasks[id].run == nullptr) {
+                    tasks[id] = {run, context, 0, 0};
+                    return id;
+                }
+            }
+            return none;
+        }
+
+        /**
+         * @brief
+         * function to stop a task until the next trigger(), a periodic task keeps its period
+         * @param id the task
+         */
+        void cancel(size_t id) {
+            if (id >= capacity or position[id] == none) {
+                return;
+            }
+            size_t index = position[id];
+            scheduled--;
+            if (index != scheduled) {
+                swap(index, scheduled);
+            }
+            position[id] = none;
+            if (index < scheduled) {
+                sift(index);
+            }
+        }
+
+        /**
+         * @brief
+         * function to get the largest time between a deadline and the start of the run of the task
+         * @return uint_fast64_t time in us
+         */
+        uint_fast64_t max_lateness_us() const {
+            return lateness_max;
+        }
+
+        /**
+         * @brief
+         * function to get the time the first task is due
+         * @return uint_fast64_t time in us, UINT_FAST64_MAX if no task is scheduled
+         */
+        uint_fast64_t next_due() const {
+            return scheduled > 0 ? tasks[heap[0]].due : UINT_FAST64_MAX;
+        }
+
+        /**
+         * @brief
+         * function to remove a task, its id can be returned by add() again
+         * @param id the task
+         */
+        void remove(size_t id) {
+            if (id < capacity) {
+                cancel(id);
+                tasks[id] = {};
+            }
+        }
+
+        /**
+         * @brief
+         * function to run the tasks, returns when no task is scheduled
+         */
+        void run() {
+            while (scheduled > 0) {
+                run_until(next_due());
+            }
+        }
+
+        /**
+         * @brief
+         * function to get the amount of runs of the tasks
+         * @return uint32_t amount of runs
+         */
+        uint32_t run_count() const {
+            return runs;
+        }
+
+        /**
+         * @brief
+         * function to run every task that's due
+         * @details
+         * A periodic task is scheduled again before it runs, so it can cancel() itself. The time is read again after
+         * every run, so a task that triggers another task without delay makes that task run in the same call. A call
+         * runs at most capacity tasks, so a task that takes longer than its period doesn't keep run_once() busy.
+         * @return boolean that's true if a task ran
+         */
+        bool run_once() {
+            bool ran = false;
+            for (size_t call_runs = 0; call_runs < capacity and scheduled > 0; call_runs++) {
+                const uint_fast64_t now = hwlib::now_us();
+                if (tasks[heap[0]].due > now) {
+                    break;
+                }
+                size_t id = heap[0];
+                task &current = tasks[id];
+                if (now - current.due > lateness_max) {
+                    lateness_max = now - current.due;
+                }
+                if (current.period_us > 0) {
+                    uint_fast64_t due = current.due + current.period_us;
+                    if (due <= now) {
+                        due += ((now - due) / current.period_us + 1) * current.period_us;
+                    }
+                    schedule(id, due);
+                } else {
+                    cancel(id);
+                }
+                runs++;
+                ran = true;
+                current.run(current.context);
+            }
+            return ran;
+        }
+
+        /**
+         * @brief
+         * function to run the tasks until a time, waits until the next deadline when no task is due
+         * @param time_us the virtual or real time in us at which run_until() returns
+         */
+        void run_until(uint_fast64_t time_us) {
+            for (;;) {
+                run_once();
+                const uint_fast64_t now = hwlib::now_us();
+                if (now >= time_us) {
+                    return;
+                }
+                uint_fast64_t until = next_due() < time_us ? next_due() : time_us;
+                if (until > now) {
+                    hwlib::wait_us(until - now < 1'000'000 ? int_fast32_t(until - now) : 1'000'000);
+                }
+            }
+        }
+
+        /**
+         * @brief
+         * function to make an event task due, or to run a periodic task earlier
+         * @param id the task
+         * @param delay_us time in us until the task is due, default value = 0
+         */
+        void trigger(size_t id, uint_fast64_t delay_us = 0) {
+            if (id < capacity and tasks[id].run != nullptr) {
+                schedule(id, hwlib::now_us() + delay_us);
+            }
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_DEADLINE_SCHEDULER_H
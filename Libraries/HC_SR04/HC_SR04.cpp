@@ -2,7 +2,7 @@
 namespace IPASS {
     HC_SR04::HC_SR04(hwlib::pin_out &trigger_pin, hwlib::pin_in &echo_pin) :
             trigger_pin(trigger_pin),
-            echo_pin(echo_pin), {
+            echo_pin(echo_pin) {
     }
 
     uint_fast64_t HC_SR04::get_time_distance() {
@@ -10,7 +10,7 @@ namespace IPASS {
         hwlib::wait_us(10);
         trigger_pin.write(false);
         while (not echo_pin.read()) {}
-        int starttime = hwlib::now_us();
+        uint_fast64_t starttime = hwlib::now_us();
         while (echo_pin.read()) {}
         uint_fast64_t finishtime = hwlib::now_us();
         uint_fast64_t time_start_object_start = finishtime - starttime;
@@ -19,6 +19,6 @@ namespace IPASS {
     }
 
     float HC_SR04::get_distance() {
-        return (get_time_distance() / 1000000) * 343;
+        return (get_time_distance() / 1000000.0f) * 343;
     }
 }
\ No newline at end of file
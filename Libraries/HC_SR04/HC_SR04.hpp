@@ -1,5 +1,5 @@
-#ifndef IPASS_APA102_H
-#define IPASS_APA102_H
+#ifndef IPASS_HC_SR04_H
+#define IPASS_HC_SR04_H
 
 #ifndef HWLIB_INC_HPP
 #define HWLIB_INC_HPP
@@ -54,4 +54,4 @@ namespace IPASS {
         float get_distance();
     };
 }
-#endif //IPASS_APA102_H
+#endif //IPASS_HC_SR04_H
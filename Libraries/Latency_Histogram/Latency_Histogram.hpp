@@ -0,0 +1,333 @@
+//======================================================================================================================
+/**
+ *  @file      Latency_Histogram.hpp
+ *  @brief     IPASS-project: Log-bucketed latency histogram with a fixed size and scoped timers.
+ */
+//======================================================================================================================
+#ifndef IPASS_LATENCY_HISTOGRAM_H
+#define IPASS_LATENCY_HISTOGRAM_H
+
+#include "hwlib.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Histogram of latencies in us with a fixed memory footprint, like a HDR histogram
+     * @details
+     * The values below 2^precision_bits us have a bucket each. Above that every power of 2 is split in
+     * 2^(precision_bits - 1) buckets, so a bucket is at most 1 / 2^(precision_bits - 1) of its value wide: 6% with the
+     * default of 5 bits. record() costs a count leading zeros, a shift and an increment, and the histogram has no heap
+     * allocation: (2^precision_bits + (max_bits - precision_bits) * 2^(precision_bits - 1)) counters of 4 bytes, 1344
+     * bytes with the defaults. Values of 2^max_bits us or more are counted in the last bucket. percentile() returns the
+     * highest value of the bucket of the percentile, so the real value is never higher than the reported value.
+     * @code
+     * IPASS::Latency_Histogram<> write_tx_us;
+     * {
+     *     IPASS_LATENCY_SCOPE(write_tx_us);
+     *     chip.write_tx(data);
+     * }
+     * write_tx_us.print("write_tx");
+     * @endcode
+     * @tparam precision_bits the amount of bits of a value that are kept, 2-8
+     * @tparam max_bits the amount of bits of the largest value, the default of 24 bits is 16.7 s
+     */
+    template<size_t precision_bits = 5, size_t max_bits = 24>
+    class Latency_Histogram {
+        static_assert(precision_bits >= 2 and precision_bits <= 8, "a Latency_Histogram keeps 2-8 bits of a value");
+        static_assert(max_bits > precision_bits and max_bits <= 32, "the values of a Latency_Histogram fit in 32 bits");
+    public:
+        /**
+         * @brief
+         * the amount of buckets
+         */
+        static constexpr size_t buckets = (size_t(1) << precision_bits) +
+                                          (max_bits - precision_bits) * (size_t(1) << (precision_bits - 1));
+
+        /**
+         * @brief
+         * RAII-object that records the time between its construction and destruction, see IPASS_LATENCY_SCOPE
+         */
+        class scope {
+        private:
+            /**
+             * @brief
+             * the histogram the time is recorded in
+             */
+            Latency_Histogram &histogram;
+            /**
+             * @brief
+             * time in us of the construction
+             */
+            uint_fast64_t start;
+
+        public:
+            /**
+             * @brief
+             * constructor for scope, starts the timer
+             * @param histogram the histogram the time is recorded in
+             */
+            explicit scope(Latency_Histogram &histogram) :
+                    histogram(histogram), start(hwlib::now_us()) {}
+
+            scope(const scope &) = delete;
+
+            /**
+             * @brief
+             * destructor for scope, records the time since the construction
+             */
+            ~scope() {
+                histogram.record_since(start);
+            }
+        };
+
+    private:
+        /**
+         * @brief
+         * the count of every bucket
+         */
+        std::array<uint32_t, buckets> counts = {};
+        /**
+         * @brief
+         * amount of recorded values
+         */
+        uint32_t total = 0;
+        /**
+         * @brief
+         * the smallest recorded value
+         */
+        uint32_t lowest = UINT32_MAX;
+        /**
+         * @brief
+         * the largest recorded value
+         */
+        uint32_t highest = 0;
+        /**
+         * @brief
+         * sum of the recorded values, for mean()
+         */
+        uint_fast64_t sum = 0;
+
+        /**
+         * @brief
+         * function to print a value right aligned in 9 characters
+         * @param out the stream to print to
+         * @param value the value
+         */
+        static void print_column(hwlib::ostream &out, uint32_t value) {
+            uint32_t digits = 1;
+            for (uint32_t rest = value; rest >= 10; rest /= 10) {
+                digits++;
+            }
+            for (; digits < 9; digits++) {
+                out << ' ';
+            }
+            out << value;
+        }
+
+    public:
+        /**
+         * @brief
+         * function to get the bucket of a value
+         * @param value the value in us
+         * @return size_t index of the bucket
+         */
+        static constexpr size_t bucket(uint32_t value) {
+            if (value < (uint32_t(1) << precision_bits)) {
+                return value;
+            }
+            if (max_bits < 32 and value >= (uint32_t(1) << (max_bits % 32))) {
+                return buckets - 1;
+            }
+            const size_t shift = size_t(31 - __builtin_clz(value)) - precision_bits + 1;
+            return (size_t(1) << precision_bits) + (shift - 1) * (size_t(1) << (precision_bits - 1)) +
+                   (value >> shift) - (size_t(1) << (precision_bits - 1));
+        }
+
+        /**
+         * @brief
+         * function to get the highest value of a bucket
+         * @param index index of the bucket
+         * @return uint32_t the highest value in us that's counted in the bucket
+         */
+        static constexpr uint32_t bucket_high(size_t index) {
+            if (index < (size_t(1) << precision_bits)) {
+                return uint32_t(index);
+            }
+            const size_t rest = index - (size_t(1) << precision_bits);
+            const size_t shift = rest / (size_t(1) << (precision_bits - 1)) + 1;
+            const uint_fast64_t sub = rest % (size_t(1) << (precision_bits - 1)) + (size_t(1) << (precision_bits - 1));
+            return uint32_t(((sub + 1) << shift) - 1);
+        }
+
+        /**
+         * @brief
+         * function to get the amount of recorded values
+         * @return uint32_t amount of values
+         */
+        uint32_t count() const {
+            return total;
+        }
+
+        /**
+         * @brief
+         * function to get the largest recorded value
+         * @return uint32_t the value in us, 0 if nothing is recorded
+         */
+        uint32_t max() const {
+            return highest;
+        }
+
+        /**
+         * @brief
+         * function to get the mean of the recorded values
+         * @return uint32_t the mean in us, 0 if nothing is recorded
+         */
+        uint32_t mean() const {
+            return total > 0 ? uint32_t(sum / total) : 0;
+        }
+
+        /**
+         * @brief
+         * function to get the smallest recorded value
+         * @return uint32_t the value in us, 0 if nothing is recorded
+         */
+        uint32_t min() const {
+            return total > 0 ? lowest : 0;
+        }
+
+        /**
+         * @brief
+         * function to get a percentile of the recorded values
+         * @param per_mille the percentile in 0.1 %: 500 for the median, 990 for p99, 999 for p99.9, 1000 for the max
+         * @return uint32_t the highest value of the bucket of the percentile, at most max(), 0 if nothing is recorded
+         */
+        uint32_t percentile(uint16_t per_mille) const {
+            if (total == 0) {
+                return 0;
+            }
+            //rank of the value, rounded up: the median of 1000 values is value 500
+            const uint_fast64_t rank = per_mille >= 1000 ? total : (uint_fast64_t(total) * per_mille + 999) / 1000;
+            uint_fast64_t seen = 0;
+            for (size_t i = 0; i < buckets; i++) {
+                seen += counts[i];
+                if (seen >= rank and seen > 0) {
+                    return bucket_high(i) < highest ? bucket_high(i) : highest;
+                }
+            }
+            return highest;
+        }
+
+        /**
+         * @brief
+         * function to print the count, the min, p50, p90, p99, p99.9 and the max in us on one line
+         * @details
+         * print_header() prints the names of the columns
+         * @param label the name of the histogram, printed in the first 24 characters
+         * @param out the stream to print to
+         */
+        void print(const char *label, hwlib::ostream &out = hwlib::cout) const {
+            size_t length = 0;
+            for (; label[length] != '\0'; length++) {
+                out << label[length];
+            }
+            for (; length < 24; length++) {
+                out << ' ';
+            }
+            for (uint32_t value : {count(), min(), percentile(500), percentile(900), percentile(990), percentile(999),
+                                   max()}) {
+                print_column(out, value);
+            }
+            out << '\n';
+        }
+
+        /**
+         * @brief
+         * function to print the non-empty buckets as CSV with a header line
+         * @details
+         * The columns are low_us, high_us and count, so a histogram can be plotted or compared between builds
+         * @param out the stream to print to
+         */
+        void print_csv(hwlib::ostream &out = hwlib::cout) const {
+            out << "low_us,high_us,count\n";
+            for (size_t i = 0; i < buckets; i++) {
+                if (counts[i] > 0) {
+                    out << (i == 0 ? 0 : bucket_high(i - 1) + 1) << ',' << bucket_high(i) << ',' << counts[i] << '\n';
+                }
+            }
+        }
+
+        /**
+         * @brief
+         * function to print the names of the columns of print()
+         * @param out the stream to print to
+         */
+        static void print_header(hwlib::ostream &out = hwlib::cout) {
+            out << "latency in us                 count      min      p50      p90      p99    p99.9      max\n";
+        }
+
+        /**
+         * @brief
+         * function to record a value
+         * @param value the value in us
+         */
+        void record(uint32_t value) {
+            counts[bucket(value)]++;
+            total++;
+            sum += value;
+            if (value < lowest) {
+                lowest = value;
+            }
+            if (value > highest) {
+                highest = value;
+            }
+        }
+
+        /**
+         * @brief
+         * function to record the time since a start time
+         * @param start_us the start time of hwlib::now_us()
+         */
+        void record_since(uint_fast64_t start_us) {
+            const uint_fast64_t delta = hwlib::now_us() - start_us;
+            record(delta < UINT32_MAX ? uint32_t(delta) : UINT32_MAX);
+        }
+
+        /**
+         * @brief
+         * function to remove all recorded values
+         */
+        void reset() {
+            counts = {};
+            total = 0;
+            lowest = UINT32_MAX;
+            highest = 0;
+            sum = 0;
+        }
+    };
+} //namespace IPASS
+
+/**
+ * @brief
+ * Records the time until the end of the enclosing block in a Latency_Histogram
+ * @details
+ * Only measures when IPASS_LATENCY is defined, with PROJECT_CPP_FLAGS += -DIPASS_LATENCY in the project makefile.
+ * Without IPASS_LATENCY the scope is compiled out and costs nothing. RF24L01 and APA102 also measure their entry
+ * points with IPASS_LATENCY, see RF24L01::latency() and APA102::latency(). Their histograms are members, so the define
+ * has to be the same for every file of the build: a #define in one file changes the layout of the classes in only
+ * that file.
+ */
+#ifdef IPASS_LATENCY
+#define IPASS_LATENCY_CONCAT(a, b) a##b
+#define IPASS_LATENCY_NAME(line) IPASS_LATENCY_CONCAT(latency_scope_, line)
+#define IPASS_LATENCY_SCOPE(histogram) \
+    typename std::remove_reference_t<decltype(histogram)>::scope IPASS_LATENCY_NAME(__LINE__)(histogram)
+#else
+#define IPASS_LATENCY_SCOPE(histogram) static_cast<void>(sizeof(histogram))
+#endif
+
+#endif //IPASS_LATENCY_HISTOGRAM_H
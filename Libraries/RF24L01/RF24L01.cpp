@@ -1,15 +1,18 @@
 #include "RF24L01.hpp"
+#include "RF24L01_Config.hpp"
 
 namespace IPASS {
     [[maybe_unused]] void RF24L01::write(const uint8_t &command, const uint8_t &value) {
         const std::array<uint8_t, 2> spi_data = {command, value};
-        bus.transaction(minion_select).write(spi_data);
+        std::array<uint8_t, 2> data_received = {};
+        bus.transaction(minion_select).write_and_read(2, spi_data.begin(), data_received.begin());
+        status = data_received[0];
     }
 
 
     [[maybe_unused]] void RF24L01::read(const uint8_t &address, uint8_t &data_out) {
-        hwlib::spi_bus::spi_transaction spi_trans = ((hwlib::spi_bus *) (&bus))->transaction(minion_select);
-        spi_trans.write(address);
+        hwlib::spi_bus::spi_transaction spi_trans = bus.transaction(minion_select);
+        spi_trans.write_and_read(1, &address, &status);
         std::array<uint8_t, 1> data_received = {};
         spi_trans.read(data_received);
         data_out = data_received[0];
@@ -17,15 +20,50 @@ namespace IPASS {
     }
 
     [[maybe_unused]] uint8_t RF24L01::read(const uint8_t &address) {
-        hwlib::spi_bus::spi_transaction spi_trans = ((hwlib::spi_bus *) (&bus))->transaction(minion_select);
-        spi_trans.write(address);
+        hwlib::spi_bus::spi_transaction spi_trans = bus.transaction(minion_select);
+        spi_trans.write_and_read(1, &address, &status);
         std::array<uint8_t, 1> data_received = {};
         spi_trans.read(data_received);
         spi_trans.~spi_transaction();
         return data_received[0];
     }
 
-    RF24L01::RF24L01(hwlib::spi_bus_bit_banged_sclk_mosi_miso &bus, hwlib::pin_out &CE_Pin,
+    void RF24L01::read(const uint8_t &command, uint8_t data[], size_t length) {
+        hwlib::spi_bus::spi_transaction spi_trans = bus.transaction(minion_select);
+        spi_trans.write_and_read(1, &command, &status);
+        spi_trans.read(length, data);
+    }
+
+    void RF24L01::write(const uint8_t &command, const uint8_t data[], size_t length) {
+        hwlib::spi_bus::spi_transaction spi_trans = bus.transaction(minion_select);
+        spi_trans.write_and_read(1, &command, &status);
+        spi_trans.write(length, data);
+    }
+
+    void RF24L01::write_address_change(const uint8_t &register_address, const std::array<uint8_t, 5> &old_address,
+                                       const std::array<uint8_t, 5> &new_address) {
+        // index 4 is the least significant byte and goes over the bus first
+        size_t length = 5;
+        while (length > 0 and old_address[5 - length] == new_address[5 - length]) {
+            length--;
+        }
+        std::array<uint8_t, 5> data = {};
+        for (size_t i = 0; i < length; i++) {
+            data[i] = new_address[4 - i];
+        }
+        if (length > 0) {
+            write(register_address | COMMAND::W_REGISTER, data.begin(), length);
+        }
+    }
+
+    bool RF24L01::shadow_cacheable(const uint8_t &address) {
+        return address <= REGISTER::RF_SETUP or
+               (address >= REGISTER::RX_ADDR_P2 and address <= REGISTER::RX_ADDR_P5) or
+               (address >= REGISTER::RX_PW_P0 and address <= REGISTER::RX_PW_P5) or
+               address == REGISTER::DYNPD or address == REGISTER::FEATURE;
+    }
+
+    RF24L01::RF24L01(hwlib::spi_bus &bus, hwlib::pin_out &CE_Pin,
                      hwlib::pin_out &minion_select, hwlib::pin_in &IRQ, std::array<uint8_t, 5> RX_ADDR_P0, std::array<uint8_t, 5> TX_ADDR,
                      uint8_t channel, bool data_rate, bool CRC, bool CRC_width) :
             bus(bus), minion_select(minion_select), CE_pin(CE_Pin), IRQ(IRQ){
@@ -38,13 +76,70 @@ namespace IPASS {
         }
     }
 
+    RF24L01::no_ack_session::no_ack_session(RF24L01 &chip) :
+            chip(chip) {
+        chip.start_no_ack_session();
+    }
+
+    RF24L01::no_ack_session::~no_ack_session() {
+        chip.stop_no_ack_session();
+    }
+
+    RF24L01::RF24L01(hwlib::spi_bus &bus, hwlib::pin_out &CE_Pin, hwlib::pin_out &minion_select, hwlib::pin_in &IRQ) :
+            bus(bus), minion_select(minion_select), CE_pin(CE_Pin), IRQ(IRQ) {}
+
+    [[maybe_unused]] void RF24L01::apply(const RF24L01_Config &config) {
+        write_CE(false);
+        register_write(REGISTER::SETUP_AW, config.setup_aw);
+        write(REGISTER::RX_ADDR_P0 | COMMAND::W_REGISTER, config.rx_addr_p0);
+        // pipe 1 holds the shared address bytes of pipes 2-5
+        if (config.en_rxaddr & 0x3E) {
+            write(REGISTER::RX_ADDR_P1 | COMMAND::W_REGISTER, config.rx_addr_p1);
+        }
+        for (uint8_t pipe = 2; pipe < 6; pipe++) {
+            if (config.en_rxaddr & (1 << pipe)) {
+                register_write(REGISTER::RX_ADDR_P0 + pipe, config.rx_addr_p2_p5[pipe - 2]);
+            }
+        }
+        write(REGISTER::TX_ADDR | COMMAND::W_REGISTER, config.tx_addr);
+        for (uint8_t pipe = 0; pipe < 6; pipe++) {
+            if (config.en_rxaddr & (1 << pipe)) {
+                register_write(REGISTER::RX_PW_P0 + pipe, config.rx_pw[pipe]);
+            }
+        }
+        register_write(REGISTER::EN_AA, config.en_aa);
+        register_write(REGISTER::EN_RXADDR, config.en_rxaddr);
+        register_write(REGISTER::SETUP_RETR, config.setup_retr);
+        register_write(REGISTER::RF_CH, config.rf_ch);
+        register_write(REGISTER::RF_SETUP, config.rf_setup);
+        if (!Active and (config.feature != 0 or config.dynpd != 0)) {
+            write_command(COMMAND::ACTIVATE);
+        }
+        // without COMMAND::ACTIVATE the chip ignores FEATURE and DYNPD, which then keep their reset value of 0
+        if (Active) {
+            register_write(REGISTER::FEATURE, config.feature);
+            register_write(REGISTER::DYNPD, config.dynpd);
+        }
+        register_write(REGISTER::STATUS, 0x70);
+        register_write(REGISTER::CONFIG, config.config);
+        dynamic_payloads = config.feature & SETTING::EN_DPL.Mask;
+        current_profile = {config.tx_addr, config.rf_ch, config.rx_pw[0], bool(config.rf_setup & SETTING::RF_DR.Mask),
+                           uint8_t((config.rf_setup >> 1) & 0x03), uint8_t(config.setup_retr >> 4),
+                           uint8_t(config.setup_retr & 0x0F)};
+        // the profile uses one address for TX_ADDR and RX_ADDR_P0
+        profile_known = config.tx_addr == config.rx_addr_p0;
+    }
+
     [[maybe_unused]] void
     RF24L01::change_ADDR(const uint8_t &register_address, const std::array<uint8_t, 5> &address_value) {
+        if (register_address == REGISTER::RX_ADDR_P0 or register_address == REGISTER::TX_ADDR) {
+            profile_known = false;
+        }
         if (register_address == REGISTER::RX_ADDR_P0 or register_address == REGISTER::RX_ADDR_P1 or
             register_address == REGISTER::TX_ADDR) {
-            write(register_address, address_value);
+            write(register_address | COMMAND::W_REGISTER, address_value);
         } else {
-            write(register_address, address_value[4]);
+            register_write(register_address, address_value[4]);
         }
     }
 
@@ -79,36 +174,280 @@ namespace IPASS {
     [[maybe_unused]] void RF24L01::change_RX_PW_P(const uint8_t &pipe, const uint8_t &value) {
         if (pipe <= 5 and pipe >= 0) {
             uint8_t address = 0x11 + pipe;
-            if (value < 0x20) {
+            if (value <= 0x20) {
                 register_write(address, value);
             }
         }
     }
 
+    [[maybe_unused]] void RF24L01::configure_pipes(const std::array<uint8_t, 5> &base_address,
+                                                   const std::array<pipe_config, 6> &pipes) {
+        uint8_t enabled = 0;
+        uint8_t auto_ack = 0;
+        for (uint8_t pipe = 0; pipe < 6; pipe++) {
+            if (pipes[pipe].enabled) {
+                enabled |= (1 << pipe);
+            }
+            if (pipes[pipe].auto_ack) {
+                auto_ack |= (1 << pipe);
+            }
+        }
+        register_write(REGISTER::EN_RXADDR, enabled);
+        register_write(REGISTER::EN_AA, auto_ack);
+        std::array<uint8_t, 5> address = base_address;
+        for (uint8_t pipe = 0; pipe < 6; pipe++) {
+            if (!pipes[pipe].enabled) {
+                continue;
+            }
+            address[4] = pipes[pipe].address;
+            change_ADDR(REGISTER::RX_ADDR_P0 + pipe, address);
+            change_RX_PW_P(pipe, pipes[pipe].width);
+        }
+        // pipe 1 holds the shared bytes, so it is written even when only pipes 2-5 are enabled
+        if (!pipes[1].enabled and (enabled & 0x3C)) {
+            address[4] = pipes[1].address;
+            change_ADDR(REGISTER::RX_ADDR_P1, address);
+        }
+    }
+
+    [[maybe_unused]] void RF24L01::disable_dynamic_payloads() {
+        if (!Active) {
+            write_command(COMMAND::ACTIVATE);
+        }
+        register_write(REGISTER::DYNPD, 0x00);
+        setting_disable<SETTING::EN_DPL>();
+        dynamic_payloads = false;
+    }
+
+    [[maybe_unused]] size_t RF24L01::drain_rx(received_payload payloads[], size_t capacity, size_t size) {
+        size_t drained = 0;
+        while (drained < capacity) {
+            received_payload &payload = payloads[drained];
+            if (read_next(payload.data.begin(), size, payload.pipe, payload.length)) {
+                drained++;
+                continue;
+            }
+            register_write(REGISTER::STATUS, SETTING::RX_DR.Mask);
+            if (last_pipe() == 0x07) {
+                break;
+            }
+        }
+        return drained;
+    }
+
+    [[maybe_unused]] bool RF24L01::dynamic_payloads_enabled() const {
+        return dynamic_payloads;
+    }
+
+    [[maybe_unused]] void RF24L01::enable_dynamic_payloads(uint8_t pipes) {
+        if (!Active) {
+            write_command(COMMAND::ACTIVATE);
+        }
+        pipes &= 0x3F;
+        register_write(REGISTER::EN_AA, register_read(REGISTER::EN_AA) | pipes);
+        setting_enable<SETTING::EN_DPL>();
+        register_write(REGISTER::DYNPD, pipes);
+        dynamic_payloads = true;
+    }
+
+    [[maybe_unused]] void RF24L01::enable_ack_payloads(uint8_t pipes) {
+        enable_dynamic_payloads(pipes | 0x01);
+        setting_enable<SETTING::EN_ACK_PAY>();
+    }
+
     [[maybe_unused]] void RF24L01::flush_rx_tx() {
         write_command(COMMAND::FLUSH_RX);
         write_command(COMMAND::FLUSH_TX);
     }
 
+    size_t RF24L01::flush_tx_count() {
+        const uint8_t fifo_status = register_read(REGISTER::FIFO_STATUS);
+        size_t count = 0;
+        if (fifo_status & SETTING::TX_FULL.Mask) {
+            count = 3;
+        } else if (not(fifo_status & SETTING::TX_EMPTY.Mask)) {
+            const uint8_t filler = 0;
+            write(COMMAND::W_TX_PAYLOAD, &filler, 1);
+            count = (update_status() & 0x01) ? 2 : 1;
+        }
+        write_command(COMMAND::FLUSH_TX);
+        return count;
+    }
+
+    [[maybe_unused]] bool RF24L01::interrupt_pending() {
+        return !IRQ.read();
+    }
+
+    [[maybe_unused]] void RF24L01::invalidate_shadow_registers() {
+        shadow_valid = 0;
+        profile_known = false;
+    }
+
+    [[maybe_unused]] uint8_t RF24L01::last_status() const {
+        return status;
+    }
+
+    [[maybe_unused]] bool RF24L01::last_status(const SETTING::Setting &registerFunction) const {
+        return (status & registerFunction.Mask) == registerFunction.Mask;
+    }
+
+    [[maybe_unused]] uint8_t RF24L01::last_pipe() const {
+        return (status >> 1) & 0x07;
+    }
+
+    [[maybe_unused]] bool RF24L01::last_tx_full() const {
+        return status & 0x01;
+    }
+
+#ifdef IPASS_LATENCY
+    [[maybe_unused]] const RF24L01::latency_histograms &RF24L01::latency() const {
+        return latency_us;
+    }
+#endif
+
+    [[maybe_unused]] bool RF24L01::load_tx(const uint8_t data[], size_t length) {
+        write(COMMAND::W_TX_PAYLOAD, data, length < 32 ? length : 32);
+        return not last_tx_full();
+    }
+
     [[maybe_unused]] bool RF24L01::packet_received() {
-        return !setting_read(SETTING::RX_EMPTY);
+        update_status();
+        return last_pipe() != 0x07;
     }
 
     [[maybe_unused]] bool RF24L01::packet_send() {
-        return !setting_read(SETTING::TX_EMPTY);
+        return !setting_read<SETTING::TX_EMPTY>();
+    }
+
+#ifdef IPASS_LATENCY
+    [[maybe_unused]] void RF24L01::print_latency(hwlib::ostream &out) const {
+        Latency_Histogram<>::print_header(out);
+        latency_us.write_tx.print("RF24L01 write_tx", out);
+        latency_us.send_packages.print("RF24L01 send_packages", out);
+        latency_us.read_rx.print("RF24L01 read_rx", out);
+    }
+#endif
+
+    [[maybe_unused]] size_t RF24L01::read_rx(uint8_t data[], size_t size) {
+#ifdef IPASS_LATENCY
+        IPASS_LATENCY_SCOPE(latency_us.read_rx);
+#endif
+        size_t length = size;
+        if (dynamic_payloads) {
+            length = read_payload_width();
+            if (length == 0) {
+                return 0;
+            }
+        }
+        if (length > size) {
+            // read the complete payload, the bytes that don't fit are clocked out and discarded
+            hwlib::spi_bus::spi_transaction spi_trans = bus.transaction(minion_select);
+            spi_trans.write_and_read(1, &COMMAND::R_RX_PAYLOAD, &status);
+            spi_trans.read(size, data);
+            uint8_t discarded[32] = {};
+            spi_trans.read(length - size, discarded);
+            return size;
+        }
+        read(COMMAND::R_RX_PAYLOAD, data, length);
+        return length;
+    }
+
+    [[maybe_unused]] size_t RF24L01::read_ack_payload(uint8_t data[], size_t size) {
+        update_status();
+        if (last_pipe() == 0x07) {
+            return 0;
+        }
+        size_t length = read_rx(data, size);
+        register_write(REGISTER::STATUS, SETTING::RX_DR.Mask);
+        return length;
+    }
+
+    bool RF24L01::read_next(uint8_t data[], size_t size, uint8_t &pipe, uint8_t &length) {
+        if (dynamic_payloads) {
+            uint8_t width = 0;
+            read(COMMAND::R_RX_PL_WID, &width, 1);
+            pipe = last_pipe();
+            if (pipe == 0x07) {
+                return false;
+            }
+            if (width == 0 or width > 32) {
+                write_command(COMMAND::FLUSH_RX);
+                return false;
+            }
+            length = width;
+            read(COMMAND::R_RX_PAYLOAD, data, length);
+            return true;
+        }
+        // the payload is only removed from the RX FIFO when its bytes are clocked out
+        hwlib::spi_bus::spi_transaction spi_trans = bus.transaction(minion_select);
+        spi_trans.write_and_read(1, &COMMAND::R_RX_PAYLOAD, &status);
+        pipe = last_pipe();
+        if (pipe == 0x07) {
+            return false;
+        }
+        const uint8_t limit = size < 32 ? size : 32;
+        length = pipe_widths[pipe] > 0 and pipe_widths[pipe] < limit ? pipe_widths[pipe] : limit;
+        spi_trans.read(length, data);
+        return true;
+    }
+
+    [[maybe_unused]] uint8_t RF24L01::read_payload_width() {
+        uint8_t width = read(COMMAND::R_RX_PL_WID);
+        if (width > 32) {
+            write_command(COMMAND::FLUSH_RX);
+            return 0;
+        }
+        return width;
     }
 
     [[maybe_unused]] uint8_t RF24L01::register_read(const uint8_t &address) {
+        if (address == REGISTER::STATUS) {
+            return update_status();
+        }
+        if (shadow_enabled and shadow_cacheable(address)) {
+            if (not(shadow_valid & (1UL << address))) {
+                shadow[address] = read(address);
+                shadow_valid |= (1UL << address);
+            }
+            return shadow[address];
+        }
         return read(address);
     }
 
     [[maybe_unused]] void RF24L01::register_read(const uint8_t &address, uint8_t &data_out) {
-        read(address, data_out);
+        data_out = register_read(address);
     }
 
     void RF24L01::register_write(const uint8_t &address, const uint8_t &value) {
         uint8_t command = address | COMMAND::W_REGISTER;
         write(command, value);
+        if (address == REGISTER::STATUS) {
+            // the STATUS byte of this write holds the interrupts before they are cleared
+            const uint8_t cleared = status & value;
+            stats.tx_ds += (cleared & SETTING::TX_DS.Mask) ? 1 : 0;
+            stats.max_rt += (cleared & SETTING::MAX_RT.Mask) ? 1 : 0;
+            stats.rx_dr += (cleared & SETTING::RX_DR.Mask) ? 1 : 0;
+        } else if (address == REGISTER::RF_CH) {
+            last_plos = 0;
+        } else if (address >= REGISTER::RX_PW_P0 and address <= REGISTER::RX_PW_P5) {
+            pipe_widths[address - REGISTER::RX_PW_P0] = value;
+        }
+        if (address == REGISTER::FEATURE) {
+            dynamic_ack = Active and (value & SETTING::EN_DYN_ACK.Mask);
+        }
+        if (address == REGISTER::RF_CH or address == REGISTER::RF_SETUP or address == REGISTER::SETUP_RETR or
+            address == REGISTER::RX_PW_P0) {
+            profile_known = false;
+        }
+        if (shadow_enabled and shadow_cacheable(address)) {
+            // without COMMAND::ACTIVATE the chip ignores writes to DYNPD and FEATURE, so read those back next time
+            if (not Active and (address == REGISTER::DYNPD or address == REGISTER::FEATURE)) {
+                shadow_valid &= ~(1UL << address);
+            } else {
+                shadow[address] = value;
+                shadow_valid |= (1UL << address);
+            }
+        }
     }
 
     [[maybe_unused]] void RF24L01::reset_arc() {
@@ -135,15 +474,43 @@ namespace IPASS {
         register_write(address, 0);
     }
 
+    [[maybe_unused]] void RF24L01::reset_statistics() {
+        stats = {};
+#ifdef IPASS_LATENCY
+        latency_us = {};
+#endif
+    }
+
+    [[maybe_unused]] void RF24L01::sample_link_statistics() {
+        const uint8_t observe = register_read(REGISTER::OBSERVE_TX);
+        const uint8_t plos = observe >> 4;
+        stats.retransmits += observe & 0x0F;
+        stats.lost += plos >= last_plos ? plos - last_plos : plos;
+        last_plos = plos;
+        stats.carrier += (register_read(REGISTER::CD) & SETTING::CD.Mask) ? 1 : 0;
+        stats.rx_full += (register_read(REGISTER::FIFO_STATUS) & SETTING::RX_FULL.Mask) ? 1 : 0;
+        stats.samples++;
+    }
+
     [[maybe_unused]] void RF24L01::send_packages() {
-        CE_pin.write(true);
-        setting_disable(SETTING::PRIM_RX);
-        CE_pin.write(false);
+#ifdef IPASS_LATENCY
+        IPASS_LATENCY_SCOPE(latency_us.send_packages);
+#endif
+        write_CE(true);
+        setting_disable<SETTING::PRIM_RX>();
+        write_CE(false);
     }
 
     [[maybe_unused]] void RF24L01::set_channel(uint8_t new_channel) {
         if (new_channel < 128) {
+            const bool listening = CE_level;
+            if (listening) {
+                write_CE(false);
+            }
             register_write(REGISTER::RF_CH, new_channel);
+            if (listening) {
+                write_CE(true);
+            }
         } else {
             hwlib::cout << new_channel << "is more than the channel-value limit of 127";
         }
@@ -174,9 +541,31 @@ namespace IPASS {
     }
 
     [[maybe_unused]] void RF24L01::start_RX() {
-        setting_enable(SETTING::PWR_UP);
-        setting_enable(SETTING::PRIM_RX);
-        CE_pin.write(true);
+        setting_enable<SETTING::PWR_UP>();
+        setting_enable<SETTING::PRIM_RX>();
+        write_CE(true);
+    }
+
+    [[maybe_unused]] void RF24L01::start_no_ack_session() {
+        if (no_ack_session_open) {
+            return;
+        }
+        no_ack_session_activated = !Active;
+        if (!Active) {
+            write_command(COMMAND::ACTIVATE);
+        }
+        uint8_t feature = register_read(REGISTER::FEATURE);
+        no_ack_session_enabled = not(feature & SETTING::EN_DYN_ACK.Mask);
+        // the write also marks dynamic_ack, even when EN_DYN_ACK was already set
+        register_write(REGISTER::FEATURE, feature | SETTING::EN_DYN_ACK.Mask);
+        no_ack_session_open = true;
+    }
+
+    [[maybe_unused]] void RF24L01::start_TX_stream() {
+        setting_disable<SETTING::PRIM_RX>();
+        setting_enable<SETTING::PWR_UP>();
+        register_write(REGISTER::STATUS, 0x70);
+        write_CE(true);
     }
 
     [[maybe_unused]] void RF24L01::start_up(std::array<uint8_t, 5> RX_ADDR_P0, std::array<uint8_t, 5> TX_ADDR,
@@ -185,26 +574,74 @@ namespace IPASS {
         change_ADDR(REGISTER::TX_ADDR, TX_ADDR);
         set_channel(channel);
         if (CRC) {
-            setting_enable(SETTING::EN_CRC);
+            setting_enable<SETTING::EN_CRC>();
             if (CRC_width) {
-                setting_enable(SETTING::CRCO);
+                setting_enable<SETTING::CRCO>();
             } else {
-                setting_disable(SETTING::CRCO);
+                setting_disable<SETTING::CRCO>();
             }
         } else {
-            setting_disable(SETTING::EN_CRC);
+            setting_disable<SETTING::EN_CRC>();
         }
         if (datarate) {
-            setting_enable(SETTING::RF_DR);
+            setting_enable<SETTING::RF_DR>();
         } else {
-            setting_disable(SETTING::RF_DR);
+            setting_disable<SETTING::RF_DR>();
         }
-        setting_enable(SETTING::PWR_UP);
+        setting_enable<SETTING::PWR_UP>();
+    }
+
+    [[maybe_unused]] const RF24L01::link_statistics &RF24L01::statistics() const {
+        return stats;
+    }
+
+    [[maybe_unused]] void RF24L01::stop_no_ack_session() {
+        if (not no_ack_session_open) {
+            return;
+        }
+        if (no_ack_session_enabled) {
+            setting_disable<SETTING::EN_DYN_ACK>();
+        }
+        if (no_ack_session_activated) {
+            write_command(COMMAND::ACTIVATE);
+        }
+        no_ack_session_open = false;
     }
 
     [[maybe_unused]] void RF24L01::stop_RX() {
-        setting_disable(SETTING::PRIM_RX);
-        CE_pin.write(false);
+        setting_disable<SETTING::PRIM_RX>();
+        write_CE(false);
+    }
+
+    [[maybe_unused]] void RF24L01::stop_TX_stream() {
+        write_CE(false);
+    }
+
+    [[maybe_unused]] void RF24L01::switch_profile(const profile &new_profile) {
+        const bool all = not profile_known;
+        const profile &old = current_profile;
+        if (all) {
+            change_ADDR(REGISTER::TX_ADDR, new_profile.address);
+            change_ADDR(REGISTER::RX_ADDR_P0, new_profile.address);
+        } else {
+            write_address_change(REGISTER::TX_ADDR, old.address, new_profile.address);
+            write_address_change(REGISTER::RX_ADDR_P0, old.address, new_profile.address);
+        }
+        if (all or new_profile.channel != old.channel) {
+            register_write(REGISTER::RF_CH, new_profile.channel & 0x7F);
+        }
+        if (all or new_profile.width != old.width) {
+            register_write(REGISTER::RX_PW_P0, new_profile.width <= 0x20 ? new_profile.width : 0x20);
+        }
+        if (all or new_profile.data_rate != old.data_rate or new_profile.power != old.power) {
+            register_write(REGISTER::RF_SETUP, (new_profile.data_rate ? SETTING::RF_DR.Mask : 0x00) |
+                                               ((new_profile.power & 0x03) << 1) | SETTING::LNA_HCURR.Mask);
+        }
+        if (all or new_profile.ard != old.ard or new_profile.arc != old.arc) {
+            register_write(REGISTER::SETUP_RETR, ((new_profile.ard & 0x0F) << 4) | (new_profile.arc & 0x0F));
+        }
+        current_profile = new_profile;
+        profile_known = true;
     }
 
     [[maybe_unused]] bool RF24L01::test() {
@@ -213,7 +650,7 @@ namespace IPASS {
             hwlib::cout << "register_read not working";
             return false;
         }
-        setting_enable(SETTING::PWR_UP);
+        setting_enable<SETTING::PWR_UP>();
         if (not(register_read(REGISTER::STATUS) & 0x02)) {
             hwlib::cout << "register_write not working";
             return false;
@@ -238,10 +675,76 @@ namespace IPASS {
         return true;
     }
 
+    [[maybe_unused]] uint8_t RF24L01::update_status() {
+        write_command(COMMAND::NOP);
+        return status;
+    }
+
+    [[maybe_unused]] void RF24L01::use_shadow_registers(bool enable) {
+        shadow_enabled = enable;
+        shadow_valid = 0;
+    }
+
     [[maybe_unused]] void RF24L01::write_command(const uint8_t &command) {
-        bus.transaction(minion_select).write(command);
         if(command == COMMAND::ACTIVATE){
+            // the features are only toggled when ACTIVATE is followed by 0x73
+            write(command, 0x73);
             Active = !Active;
+            dynamic_ack = false;
+            shadow_valid &= ~((1UL << REGISTER::DYNPD) | (1UL << REGISTER::FEATURE));
+        } else {
+            bus.transaction(minion_select).write_and_read(1, &command, &status);
+        }
+    }
+
+    [[maybe_unused]] bool RF24L01::write_ack_payload(uint8_t pipe, const uint8_t data[], size_t length) {
+        if (pipe > 5) {
+            return false;
+        }
+        if (length > 32) {
+            length = 32;
+        }
+        write(COMMAND::W_ACK_PAYLOAD | pipe, data, length);
+        // the STATUS byte is clocked out before the payload, so TX_FULL tells if there was room
+        return not(status & 0x01);
+    }
+
+    void RF24L01::write_CE(bool level) {
+        CE_pin.write(level);
+        CE_level = level;
+    }
+
+    [[maybe_unused]] void RF24L01::write_tx(const uint8_t data[], size_t length, bool no_ack) {
+#ifdef IPASS_LATENCY
+        IPASS_LATENCY_SCOPE(latency_us.write_tx);
+#endif
+        if (length > 32) {
+            length = 32;
+        }
+        if (no_ack and dynamic_ack) {
+            write(COMMAND::W_TX_PAYLOAD_NO_ACK, data, length);
+            // TX_DS is left set, a payload without ack can't set MAX_RT
+            if (status & SETTING::MAX_RT.Mask) {
+                register_write(REGISTER::STATUS, SETTING::MAX_RT.Mask);
+            }
+            return;
+        }
+        if (no_ack) {
+            bool prev_active = Active;
+            if(!prev_active) {
+                write_command(COMMAND::ACTIVATE);
+            }
+            setting_enable<SETTING::EN_DYN_ACK>();
+            write(COMMAND::W_TX_PAYLOAD_NO_ACK, data, length);
+            setting_disable<SETTING::EN_DYN_ACK>();
+            if(!prev_active) {
+                write_command(COMMAND::ACTIVATE);
+            }
+        } else {
+            write(COMMAND::W_TX_PAYLOAD, data, length);
+        }
+        if (status & 0x70) {
+            register_write(REGISTER::STATUS, status & 0x70);
         }
     }
 }
\ No newline at end of file
@@ -16,6 +16,8 @@
 
 #endif //HWLIB_INC_HPP
 
+#include "../Latency_Histogram/Latency_Histogram.hpp"
+
 /**
  * @brief
  * IPASS namespace to prevent name clashes
@@ -23,6 +25,8 @@
 
 namespace IPASS {
 
+    class RF24L01_Config;
+
     /**
      * @brief
      * Class for the RF24L01
@@ -35,7 +39,7 @@ namespace IPASS {
          * @brief
          * SPI-Bus to read and write to the chip
          */
-        hwlib::spi_bus_bit_banged_sclk_mosi_miso &bus;
+        hwlib::spi_bus &bus;
         /**
          * @brief
          * hwlib::pin_out object which contains the pin connected to CSN pin of the RF24L01
@@ -58,6 +62,77 @@ namespace IPASS {
          */
         bool Active = false;
 
+        /**
+         * @brief
+         * boolean that indicates if the shadow registers are used, see use_shadow_registers()
+         */
+        bool shadow_enabled = false;
+
+        /**
+         * @brief
+         * bitmask with one bit per register address that indicates which entries of shadow hold the value of the chip
+         */
+        uint32_t shadow_valid = 0;
+
+        /**
+         * @brief
+         * Shadow copy of the single byte configuration registers from REGISTER::CONFIG through REGISTER::FEATURE
+         * @details
+         * Indexed by register address, only the entries marked in shadow_valid are used
+         */
+        std::array<uint8_t, 0x1E> shadow = {};
+
+        /**
+         * @brief
+         * Copy of the STATUS register that the RF24L01 clocked out as first byte of the last SPI-transaction
+         * @details
+         * Initialised with the reset value of REGISTER::STATUS
+         */
+        uint8_t status = 0x0E;
+
+        /**
+         * @brief
+         * boolean that indicates if dynamic payload length is enabled with enable_dynamic_payloads()
+         */
+        bool dynamic_payloads = false;
+
+        /**
+         * @brief
+         * boolean that indicates if the features are active and SETTING::EN_DYN_ACK is set, so a payload without ack is
+         * written with one SPI-transaction
+         */
+        bool dynamic_ack = false;
+
+        /**
+         * @brief
+         * boolean that indicates if a session is started with start_no_ack_session()
+         */
+        bool no_ack_session_open = false;
+
+        /**
+         * @brief
+         * boolean that contains the level of the CE pin, see write_CE()
+         */
+        bool CE_level = false;
+
+        /**
+         * @brief
+         * payload width of every pipe as written to REGISTER::RX_PW_P0-5 by this driver, 0 if it's not written
+         */
+        std::array<uint8_t, 6> pipe_widths = {};
+
+        /**
+         * @brief
+         * boolean that indicates if start_no_ack_session() wrote COMMAND::ACTIVATE, stop_no_ack_session() writes it again
+         */
+        bool no_ack_session_activated = false;
+
+        /**
+         * @brief
+         * boolean that indicates if start_no_ack_session() set SETTING::EN_DYN_ACK, stop_no_ack_session() clears it again
+         */
+        bool no_ack_session_enabled = false;
+
         /**
          * @brief
          * Private read function
@@ -69,8 +144,8 @@ namespace IPASS {
          */
         template<size_t amount>
         [[maybe_unused]] void read(const uint8_t &address, std::array<uint8_t, amount> &data_out) {
-            hwlib::spi_bus::spi_transaction spi_trans = ((hwlib::spi_bus *) (&bus))->transaction(minion_select);
-            spi_trans.write(address);
+            hwlib::spi_bus::spi_transaction spi_trans = bus.transaction(minion_select);
+            spi_trans.write_and_read(1, &address, &status);
             std::array<uint8_t, amount> data_received = {};
             spi_trans.read(data_received);
             for (unsigned int i = 0; i < amount; i++) {
@@ -99,6 +174,29 @@ namespace IPASS {
          */
         [[maybe_unused]] void read(const uint8_t &address, uint8_t &data_out);
 
+        /**
+         * @brief
+         * Private read function
+         * @details
+         * Read function that writes the command and reads length bytes directly into data, data[0] is the first byte
+         * clocked out by the RF24L01
+         * @param command uint8_t that contains the SPI-command
+         * @param data buffer of at least length bytes
+         * @param length amount of bytes to read
+         */
+        void read(const uint8_t &command, uint8_t data[], size_t length);
+
+        /**
+         * @brief
+         * Private function to check if a register can be kept in the shadow registers
+         * @details
+         * Only the single byte configuration registers can be kept, the status registers REGISTER::STATUS,
+         * REGISTER::OBSERVE_TX, REGISTER::CD, REGISTER::FIFO_STATUS and the 5 byte address registers are always read from the chip
+         * @param address uint8_t that contains the register address
+         * @return returns true if the register can be kept in the shadow registers
+         */
+        static bool shadow_cacheable(const uint8_t &address);
+
         /**
          * @brief
          * Startup function
@@ -129,7 +227,9 @@ namespace IPASS {
             for (unsigned int index = 1; index < amount + 1; index++) {
                 spi_data[index] = value[amount - index];
             }
-            bus.transaction(minion_select).write(spi_data);
+            std::array<uint8_t, amount + 1> data_received = {};
+            bus.transaction(minion_select).write_and_read(amount + 1, spi_data.begin(), data_received.begin());
+            status = data_received[0];
         }
 
         /**
@@ -142,12 +242,24 @@ namespace IPASS {
          */
         [[maybe_unused]] void write(const uint8_t &command, const uint8_t &value);
 
+        /**
+         * @brief
+         * Private write function
+         * @details
+         * Write function that writes the command and length bytes directly from data, data[0] is the first byte
+         * clocked in by the RF24L01
+         * @param command uint8_t that contains the SPI-command
+         * @param data buffer of at least length bytes
+         * @param length amount of bytes to write
+         */
+        void write(const uint8_t &command, const uint8_t data[], size_t length);
+
     public:
         /**
          * @brief
          * SUBCLASS COMMAND
          * @details
-         * SUBCLASS COMMAND that contains only out of static const uint8_t with the addresses of the RF24L01-registers
+         * SUBCLASS COMMAND that contains only out of constexpr static uint8_t with the addresses of the RF24L01-registers
          * @warning the commands are just mask and because of that they can not be used without some change so read datasheet before calling these commands
          * you can crash your program by executing command without knowing what is does.
          * */
@@ -155,230 +267,230 @@ namespace IPASS {
         public:
             /**
             * @brief
-             * const static uint8_t that contains the value of the read_register command of the RF24L01
+             * constexpr static uint8_t that contains the value of the read_register command of the RF24L01
              */
-            [[maybe_unused]] static const uint8_t R_REGISTER;
+            [[maybe_unused]] static constexpr uint8_t R_REGISTER = 0x00;
             /**
              * @brief
-             * const static uint8_t that contains the value of the write_register command of the RF24L01
+             * constexpr static uint8_t that contains the value of the write_register command of the RF24L01
              * @details
              * used to write data to the registers of the RF24L01
              * @note
              * can only be used in standby or power down mode
              */
-            [[maybe_unused]] static const uint8_t W_REGISTER;
+            [[maybe_unused]] static constexpr uint8_t W_REGISTER = 0x20;
             /**
              * @brief
-             * const static uint8_t that contains the value of the read_receive_payload command of the RF24L01
+             * constexpr static uint8_t that contains the value of the read_receive_payload command of the RF24L01
              * @details
              * Read 1-32 bytes from the RX-payload. It starts at byte 0 and the payload is deleted from FIFO after it was read
              */
-            [[maybe_unused]] static const uint8_t R_RX_PAYLOAD;
+            [[maybe_unused]] static constexpr uint8_t R_RX_PAYLOAD = 0x61;
             /**
              * @brief
-             * const static uint8_t that contains the value of the write_transmit_payload command of the RF24L01
+             * constexpr static uint8_t that contains the value of the write_transmit_payload command of the RF24L01
              * @details
              * Write 1-32 bytes to the TX-payload
              */
-            [[maybe_unused]] static const uint8_t W_TX_PAYLOAD;
+            [[maybe_unused]] static constexpr uint8_t W_TX_PAYLOAD = 0xA0;
             /**
              * @brief
-             * const static uint8_t that contains the value of the flush_transmit command of the RF24L01
+             * constexpr static uint8_t that contains the value of the flush_transmit command of the RF24L01
              * @details
              * Flush the TX-fifo
              */
-            [[maybe_unused]] static const uint8_t FLUSH_TX;
+            [[maybe_unused]] static constexpr uint8_t FLUSH_TX = 0xE1;
             /**
              * @brief
-             * const static uint8_t that contains the value of the flush_receive command of the RF24L01
+             * constexpr static uint8_t that contains the value of the flush_receive command of the RF24L01
              * @details
              * Flush the RX-fifo
              */
-            [[maybe_unused]] static const uint8_t FLUSH_RX;
+            [[maybe_unused]] static constexpr uint8_t FLUSH_RX = 0xE2;
             /**
              * @brief
-             * const static uint8_t that contains the value of the re-use transmit payload command of the RF24L01
+             * constexpr static uint8_t that contains the value of the re-use transmit payload command of the RF24L01
              * @details
              * Can be used in TX-mode to retransmit last send package as long as CE is high or W_TX_payload / FLUSH_TX executed
              * @warning
              * Should note be activated or deactivated during packet transmission.
              */
-            [[maybe_unused]] static const uint8_t REUSE_TX_PL;
+            [[maybe_unused]] static constexpr uint8_t REUSE_TX_PL = 0xE3;
             /**
              * @brief
-             * const static uint8_t that contains the value of the activate command of the RF24L01
+             * constexpr static uint8_t that contains the value of the activate command of the RF24L01
              * @details
              * Used to activate or deactivate the R_RX_PL_WID, W_ACK_PAYLOAD, W_TX_PAYLOAD_NOACK features
              */
-            [[maybe_unused]] static const uint8_t ACTIVATE;
+            [[maybe_unused]] static constexpr uint8_t ACTIVATE = 0x50;
             /**
              * @brief
-             * const static uint8_t that contains the value of the R_RX_PL_WID command of the RF24L01
+             * constexpr static uint8_t that contains the value of the R_RX_PL_WID command of the RF24L01
              * @details
              * read the payload width for the next R_RX_PAYLOAD in RX_FIFO
              */
-            [[maybe_unused]] static const uint8_t R_RX_PL_WID;
+            [[maybe_unused]] static constexpr uint8_t R_RX_PL_WID = 0x60;
             /**
              * @brief
-             * const static uint8_t that contains the value of the W_ACK_PAYLOAD command of the RF24L01
+             * constexpr static uint8_t that contains the value of the W_ACK_PAYLOAD command of the RF24L01
              * @details
              * Write 1-32 bytes to TX_FIFO with acknowledge on a specific pipe
              */
-            [[maybe_unused]] static const uint8_t W_ACK_PAYLOAD;
+            [[maybe_unused]] static constexpr uint8_t W_ACK_PAYLOAD = 0xa8;
             /**
              * @brief
-             * const static uint8_t that contains the value of the W_TX_PAYLOAD_NO_ACK command of the RF24L01
+             * constexpr static uint8_t that contains the value of the W_TX_PAYLOAD_NO_ACK command of the RF24L01
              * @details
              * Write 1-32 bytes to TX_FIFO to be send without a acknowledge on this package
              */
-            [[maybe_unused]] static const uint8_t W_TX_PAYLOAD_NO_ACK;
+            [[maybe_unused]] static constexpr uint8_t W_TX_PAYLOAD_NO_ACK = 0xb0;
             /**
              * @brief
-             * const static uint8_t that contains the value of the NOP command of the RF24L01
+             * constexpr static uint8_t that contains the value of the NOP command of the RF24L01
              * @details
              * No operation implemented can be used to read the status register
              */
-            [[maybe_unused]] static const uint8_t NOP;
+            [[maybe_unused]] static constexpr uint8_t NOP = 0xff;
         };
 
         /**
          * @brief
          * SUBCLASS REGISTER
          * @details
-         * SUBCLASS REGISTER that contains only out of static const uint8_t with the addresses of the RF24L01-registers
+         * SUBCLASS REGISTER that contains only out of constexpr static uint8_t with the addresses of the RF24L01-registers
          */
         class REGISTER {
         public:
             /**
             * @brief
-            * const static uint8_t that contains the CONFIG-register address of the RF24L01
+            * constexpr static uint8_t that contains the CONFIG-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t CONFIG;
+            [[maybe_unused]] static constexpr uint8_t CONFIG = 0x00;
             /**
             * @brief
-            * const static uint8_t that contains the EN_AA-register address of the RF24L01
+            * constexpr static uint8_t that contains the EN_AA-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t EN_AA;
+            [[maybe_unused]] static constexpr uint8_t EN_AA = 0x01;
             /**
             * @brief
-            * const static uint8_t that contains the EN_RXADDR-register address of the RF24L01
+            * constexpr static uint8_t that contains the EN_RXADDR-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t EN_RXADDR;
+            [[maybe_unused]] static constexpr uint8_t EN_RXADDR = 0x02;
             /**
             * @brief
-            * const static uint8_t that contains the SETUP_AW-register address of the RF24L01
+            * constexpr static uint8_t that contains the SETUP_AW-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t SETUP_AW;
+            [[maybe_unused]] static constexpr uint8_t SETUP_AW = 0x03;
             /**
             * @brief
-            * const static uint8_t that contains the SETUP_RETR-register address of the RF24L01
+            * constexpr static uint8_t that contains the SETUP_RETR-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t SETUP_RETR;
+            [[maybe_unused]] static constexpr uint8_t SETUP_RETR = 0x04;
             /**
             * @brief
-            * const static uint8_t that contains the RF_CH-register address of the RF24L01
+            * constexpr static uint8_t that contains the RF_CH-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RF_CH;
+            [[maybe_unused]] static constexpr uint8_t RF_CH = 0x05;
             /**
             * @brief
-            * const static uint8_t that contains the RF_SETUP-register address of the RF24L01
+            * constexpr static uint8_t that contains the RF_SETUP-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RF_SETUP;
+            [[maybe_unused]] static constexpr uint8_t RF_SETUP = 0x06;
             /**
             * @brief
-            * const static uint8_t that contains the STATUS-register address of the RF24L01
+            * constexpr static uint8_t that contains the STATUS-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t STATUS;
+            [[maybe_unused]] static constexpr uint8_t STATUS = 0x07;
             /**
             * @brief
-            * const static uint8_t that contains the OBSERVE_TX-register address of the RF24L01
+            * constexpr static uint8_t that contains the OBSERVE_TX-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t OBSERVE_TX;
+            [[maybe_unused]] static constexpr uint8_t OBSERVE_TX = 0x08;
             /**
             * @brief
-            * const static uint8_t that contains the CD-register address of the RF24L01
+            * constexpr static uint8_t that contains the CD-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t CD;
+            [[maybe_unused]] static constexpr uint8_t CD = 0x09;
             /**
             * @brief
-            * const static uint8_t that contains the RX_ADDR_P0-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_ADDR_P0-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_ADDR_P0;
+            [[maybe_unused]] static constexpr uint8_t RX_ADDR_P0 = 0x0A;
             /**
             * @brief
-            * const static uint8_t that contains the RX_ADDR_P1-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_ADDR_P1-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_ADDR_P1;
+            [[maybe_unused]] static constexpr uint8_t RX_ADDR_P1 = 0x0B;
             /**
             * @brief
-            * const static uint8_t that contains the RX_ADDR_P2-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_ADDR_P2-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_ADDR_P2;
+            [[maybe_unused]] static constexpr uint8_t RX_ADDR_P2 = 0x0C;
             /**
             * @brief
-            * const static uint8_t that contains the RX_ADDR_P3-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_ADDR_P3-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_ADDR_P3;
+            [[maybe_unused]] static constexpr uint8_t RX_ADDR_P3 = 0x0D;
             /**
             * @brief
-            * const static uint8_t that contains the RX_ADDR_P4-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_ADDR_P4-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_ADDR_P4;
+            [[maybe_unused]] static constexpr uint8_t RX_ADDR_P4 = 0x0E;
             /**
             * @brief
-            * const static uint8_t that contains the RX_ADDR_P5-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_ADDR_P5-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_ADDR_P5;
+            [[maybe_unused]] static constexpr uint8_t RX_ADDR_P5 = 0x0F;
             /**
             * @brief
-            * const static uint8_t that contains the TX_ADDR-register address of the RF24L01
+            * constexpr static uint8_t that contains the TX_ADDR-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t TX_ADDR;
+            [[maybe_unused]] static constexpr uint8_t TX_ADDR = 0x10;
             /**
             * @brief
-            * const static uint8_t that contains the RX_PW_P0-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_PW_P0-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_PW_P0;
+            [[maybe_unused]] static constexpr uint8_t RX_PW_P0 = 0x11;
             /**
             * @brief
-            * const static uint8_t that contains the RX_PW_P1-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_PW_P1-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_PW_P1;
+            [[maybe_unused]] static constexpr uint8_t RX_PW_P1 = 0x12;
             /**
             * @brief
-            * const static uint8_t that contains the RX_PW_P2-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_PW_P2-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_PW_P2;
+            [[maybe_unused]] static constexpr uint8_t RX_PW_P2 = 0x13;
             /**
             * @brief
-            * const static uint8_t that contains the RX_PW_P3-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_PW_P3-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_PW_P3;
+            [[maybe_unused]] static constexpr uint8_t RX_PW_P3 = 0x14;
             /**
             * @brief
-            * const static uint8_t that contains the RX_PW_P4-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_PW_P4-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_PW_P4;
+            [[maybe_unused]] static constexpr uint8_t RX_PW_P4 = 0x15;
             /**
             * @brief
-            * const static uint8_t that contains the RX_PW_P5-register address of the RF24L01
+            * constexpr static uint8_t that contains the RX_PW_P5-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t RX_PW_P5;
+            [[maybe_unused]] static constexpr uint8_t RX_PW_P5 = 0x16;
             /**
             * @brief
-            * const static uint8_t that contains the FIFO_STATUS-register address of the RF24L01
+            * constexpr static uint8_t that contains the FIFO_STATUS-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t FIFO_STATUS;
+            [[maybe_unused]] static constexpr uint8_t FIFO_STATUS = 0x17;
             /**
             * @brief
-            * const static uint8_t that contains the DYNPD-register address of the RF24L01
+            * constexpr static uint8_t that contains the DYNPD-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t DYNPD;
+            [[maybe_unused]] static constexpr uint8_t DYNPD = 0x1C;
             /**
             * @brief
-            * const static uint8_t that contains the FEATURE-register address of the RF24L01
+            * constexpr static uint8_t that contains the FEATURE-register address of the RF24L01
             */
-            [[maybe_unused]] static const uint8_t FEATURE;
+            [[maybe_unused]] static constexpr uint8_t FEATURE = 0x1D;
 
         };
 
@@ -394,15 +506,17 @@ namespace IPASS {
              * @brief
              * Struct Setting
              * @details
-             * Struct that contains the name of the register and the mask of the settings
+             * Struct that contains the address of the register, the mask and the reset value of the settings by value,
+             * so the settings are constexpr and cost no RAM. Pass them as template argument to setting_enable(),
+             * setting_disable(), setting_read() and setting_reset() to get the register and mask at compile time.
              */
             struct Setting {
-                ///const uint8_t that contains the address of the register
-                const uint8_t &REGISTER_ADDR;
-                ///const uint8_t that contains the mask to identify the bit of the setting
-                const uint8_t &Mask;
-                ///const boolean that contains the standard value to reset the function
-                const bool &Reset_Value;
+                ///uint8_t that contains the address of the register
+                uint8_t REGISTER_ADDR;
+                ///uint8_t that contains the mask to identify the bit of the setting
+                uint8_t Mask;
+                ///boolean that contains the standard value to reset the function
+                bool Reset_Value;
 
                 /**
                  * @brief
@@ -410,7 +524,7 @@ namespace IPASS {
                  * @details
                  * operator that checks of the content of two structs is equal
                  */
-                bool operator==(const Setting &rhs) const &{
+                constexpr bool operator==(const Setting &rhs) const {
                     return (REGISTER_ADDR == rhs.REGISTER_ADDR and Mask == rhs.Mask);
                 }
             };
@@ -421,21 +535,21 @@ namespace IPASS {
              * @details
              * The Mask_RX_DR setting manages if the RX_DR interrupt is reflected on the IRQ-pin
              */
-            [[maybe_unused]] static Setting Mask_RX_DR;
+            [[maybe_unused]] static constexpr Setting Mask_RX_DR = {REGISTER::CONFIG, 0x40, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the Mask_TX_DS-setting
              * @details
              * The Mask_TX_DS setting manages if the TX_DS interrupt is reflected on the IRQ-pin
              */
-            [[maybe_unused]] static Setting Mask_TX_DS;
+            [[maybe_unused]] static constexpr Setting Mask_TX_DS = {REGISTER::CONFIG, 0x20, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the Mask_MAX_RT-setting
              * @details
              * The Mask_MAX_RT setting manages if the MAX_RT interrupt is reflected on the IRQ-pin
              */
-            [[maybe_unused]] static Setting Mask_MAX_RT;
+            [[maybe_unused]] static constexpr Setting Mask_MAX_RT = {REGISTER::CONFIG, 0x10, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the EN_CRC-setting
@@ -444,14 +558,14 @@ namespace IPASS {
              * @note
              * Function is forced high if on off the bits in EN_AA is high
              */
-            [[maybe_unused]] static Setting EN_CRC;
+            [[maybe_unused]] static constexpr Setting EN_CRC = {REGISTER::CONFIG, 0x08, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the CRCO-setting
              * @details
              * The CRCO setting manages if the CRCO is 1 or 2 bytes long
              */
-            [[maybe_unused]] static Setting CRCO;
+            [[maybe_unused]] static constexpr Setting CRCO = {REGISTER::CONFIG, 0x04, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the PWR_UP-setting
@@ -460,7 +574,7 @@ namespace IPASS {
              * - High is Power up
              * - Low is Power down
              */
-            [[maybe_unused]] static Setting PWR_UP;
+            [[maybe_unused]] static constexpr Setting PWR_UP = {REGISTER::CONFIG, 0x02, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the PRIM_RX-setting
@@ -469,7 +583,7 @@ namespace IPASS {
              * - High is RX-mode
              * - Low is TX-mode
              */
-            [[maybe_unused]] static Setting PRIM_RX;
+            [[maybe_unused]] static constexpr Setting PRIM_RX = {REGISTER::CONFIG, 0x01, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ENAA_P5-setting
@@ -478,7 +592,7 @@ namespace IPASS {
              * - High is enabled
              * - Low is disabled
              */
-            [[maybe_unused]] static Setting ENAA_P5;
+            [[maybe_unused]] static constexpr Setting ENAA_P5 = {REGISTER::EN_AA, 0x20, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ENAA_P4-setting
@@ -487,7 +601,7 @@ namespace IPASS {
              * - High is enabled
              * - Low is disabled
              */
-            [[maybe_unused]] static Setting ENAA_P4;
+            [[maybe_unused]] static constexpr Setting ENAA_P4 = {REGISTER::EN_AA, 0x10, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ENAA_P3-setting
@@ -496,7 +610,7 @@ namespace IPASS {
              * - High is enabled
              * - Low is disabled
              */
-            [[maybe_unused]] static Setting ENAA_P3;
+            [[maybe_unused]] static constexpr Setting ENAA_P3 = {REGISTER::EN_AA, 0x08, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ENAA_P2-setting
@@ -505,7 +619,7 @@ namespace IPASS {
              * - High is enabled
              * - Low is disabled
              */
-            [[maybe_unused]] static Setting ENAA_P2;
+            [[maybe_unused]] static constexpr Setting ENAA_P2 = {REGISTER::EN_AA, 0x04, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ENAA_P1-setting
@@ -514,7 +628,7 @@ namespace IPASS {
              * - High is enabled
              * - Low is disabled
              */
-            [[maybe_unused]] static Setting ENAA_P1;
+            [[maybe_unused]] static constexpr Setting ENAA_P1 = {REGISTER::EN_AA, 0x02, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ENAA_P0-setting
@@ -523,49 +637,49 @@ namespace IPASS {
              * - High is enabled
              * - Low is disabled
              */
-            [[maybe_unused]] static Setting ENAA_P0;
+            [[maybe_unused]] static constexpr Setting ENAA_P0 = {REGISTER::EN_AA, 0x01, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ERX_P5-setting
              * @details
              * The ERX_P5 setting controls if pipe 5 is enabled
              */
-            [[maybe_unused]] static Setting ERX_P5;
+            [[maybe_unused]] static constexpr Setting ERX_P5 = {REGISTER::EN_RXADDR, 0x20, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ERX_P4-setting
              * @details
              * The ERX_P4 setting controls if pipe 4 is enabled
              */
-            [[maybe_unused]] static Setting ERX_P4;
+            [[maybe_unused]] static constexpr Setting ERX_P4 = {REGISTER::EN_RXADDR, 0x10, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ERX_P3-setting
              * @details
              * The ERX_P3 setting controls if pipe 3 is enabled
              */
-            [[maybe_unused]] static Setting ERX_P3;
+            [[maybe_unused]] static constexpr Setting ERX_P3 = {REGISTER::EN_RXADDR, 0x08, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ERX_P2-setting
              * @details
              * The ERX_P2 setting controls if pipe 2 is enabled
              */
-            [[maybe_unused]] static Setting ERX_P2;
+            [[maybe_unused]] static constexpr Setting ERX_P2 = {REGISTER::EN_RXADDR, 0x04, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ERX_P1-setting
              * @details
              * The ERX_P1 setting controls if pipe 1 is enabled
              */
-            [[maybe_unused]] static Setting ERX_P1;
+            [[maybe_unused]] static constexpr Setting ERX_P1 = {REGISTER::EN_RXADDR, 0x02, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the ERX_P0-setting
              * @details
              * The ERX_P0 setting controls if pipe 0 is enabled
              */
-            [[maybe_unused]] static Setting ERX_P0;
+            [[maybe_unused]] static constexpr Setting ERX_P0 = {REGISTER::EN_RXADDR, 0x01, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the PLL_LOCK-setting
@@ -575,7 +689,7 @@ namespace IPASS {
              * @warning
              * Only used for testing
              */
-            [[maybe_unused]] static Setting PLL_LOCK;
+            [[maybe_unused]] static constexpr Setting PLL_LOCK = {REGISTER::RF_SETUP, 0x10, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the RF_DR-setting
@@ -584,7 +698,7 @@ namespace IPASS {
              * - High is 2 Mbps
              * - Low is 1 Mbps
              */
-            [[maybe_unused]] static Setting RF_DR;
+            [[maybe_unused]] static constexpr Setting RF_DR = {REGISTER::RF_SETUP, 0x08, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the LNA_HCURR-setting
@@ -592,14 +706,14 @@ namespace IPASS {
              * The LNA_HCURR setting is used to enable LNA gain<BR>
              * For more info: <a href=https://en.wikipedia.org/wiki/Low-noise_amplifier#Gain> LNA gain info</a>
              */
-            [[maybe_unused]] static Setting LNA_HCURR;
+            [[maybe_unused]] static constexpr Setting LNA_HCURR = {REGISTER::RF_SETUP, 0x01, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the RX_DR-setting
              * @details
              * The RX_DR setting is an Data Ready RX FIFO interrupt. Which is reset when new data arrives
              */
-            [[maybe_unused]] static Setting RX_DR;
+            [[maybe_unused]] static constexpr Setting RX_DR = {REGISTER::STATUS, 0x40, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the TX_DS-setting
@@ -607,14 +721,14 @@ namespace IPASS {
              * The TX_DS setting is an Data Send TX FIFO interrupt. Which is reset when new data is send.
              * IF AUTO_ACK is activated this bit is only high when the acknowledgement is received
              */
-            [[maybe_unused]] static Setting TX_DS;
+            [[maybe_unused]] static constexpr Setting TX_DS = {REGISTER::STATUS, 0x20, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the MAX_RT-setting
              * @details
              * The MAX_RT setting is an interrupt which is enabled when the maximum number of retries is reached
              */
-            [[maybe_unused]] static Setting MAX_RT;
+            [[maybe_unused]] static constexpr Setting MAX_RT = {REGISTER::STATUS, 0x10, false};
 
             /**
              * @brief
@@ -627,7 +741,7 @@ namespace IPASS {
              * @note
              * Only recommended to use if the TX device does not succeed to get packets through
              */
-            [[maybe_unused]] static Setting CD;
+            [[maybe_unused]] static constexpr Setting CD = {REGISTER::CD, 0x01, false};
 
             /**
              * @brief
@@ -638,7 +752,7 @@ namespace IPASS {
              * @note
              * read only
              */
-            [[maybe_unused]] static Setting TX_REUSE;
+            [[maybe_unused]] static constexpr Setting TX_REUSE = {REGISTER::FIFO_STATUS, 0x10, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the TX_FULL-setting
@@ -647,7 +761,7 @@ namespace IPASS {
              * @note
              * read only
              */
-            [[maybe_unused]] static Setting TX_FULL;
+            [[maybe_unused]] static constexpr Setting TX_FULL = {REGISTER::FIFO_STATUS, 0x20, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the TX_EMPTY-setting
@@ -656,7 +770,7 @@ namespace IPASS {
              * @note
              * read only
              */
-            [[maybe_unused]] static Setting TX_EMPTY;
+            [[maybe_unused]] static constexpr Setting TX_EMPTY = {REGISTER::FIFO_STATUS, 0x10, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the RX_FULL-setting
@@ -665,7 +779,7 @@ namespace IPASS {
              * @note
              * read only
              */
-            [[maybe_unused]] static Setting RX_FULL;
+            [[maybe_unused]] static constexpr Setting RX_FULL = {REGISTER::FIFO_STATUS, 0x02, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the RX_EMPTY-setting
@@ -674,7 +788,7 @@ namespace IPASS {
              * @note
              * read only
              */
-            [[maybe_unused]] static Setting RX_EMPTY;
+            [[maybe_unused]] static constexpr Setting RX_EMPTY = {REGISTER::FIFO_STATUS, 0x01, true};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the DPL_P5-setting
@@ -685,7 +799,7 @@ namespace IPASS {
              * EN_DPL and ENAA_P5 to be HIGH
              * To change this value you first need to write COMMAND::ACTIVATE to the RF24L01
              */
-            [[maybe_unused]] static Setting DPL_P5;
+            [[maybe_unused]] static constexpr Setting DPL_P5 = {REGISTER::DYNPD, 0x20, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the DPL_P4-setting
@@ -696,7 +810,7 @@ namespace IPASS {
              * EN_DPL and ENAA_P4 to be HIGH
              * To change this value you first need to write COMMAND::ACTIVATE to the RF24L01
              */
-            [[maybe_unused]] static Setting DPL_P4;
+            [[maybe_unused]] static constexpr Setting DPL_P4 = {REGISTER::DYNPD, 0x10, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the DPL_P3-setting
@@ -707,7 +821,7 @@ namespace IPASS {
              * EN_DPL and ENAA_P3 to be HIGH
              * To change this value you first need to write COMMAND::ACTIVATE to the RF24L01
              */
-            [[maybe_unused]] static Setting DPL_P3;
+            [[maybe_unused]] static constexpr Setting DPL_P3 = {REGISTER::DYNPD, 0x08, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the DPL_P2-setting
@@ -718,7 +832,7 @@ namespace IPASS {
              * EN_DPL and ENAA_P2 to be HIGH
              * To change this value you first need to write COMMAND::ACTIVATE to the RF24L01
              */
-            [[maybe_unused]] static Setting DPL_P2;
+            [[maybe_unused]] static constexpr Setting DPL_P2 = {REGISTER::DYNPD, 0x04, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the DPL_P1-setting
@@ -729,7 +843,7 @@ namespace IPASS {
              * EN_DPL and ENAA_P1 to be HIGH
              * To change this value you first need to write COMMAND::ACTIVATE to the RF24L01
              */
-            [[maybe_unused]] static Setting DPL_P1;
+            [[maybe_unused]] static constexpr Setting DPL_P1 = {REGISTER::DYNPD, 0x02, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the DPL_P0-setting
@@ -740,7 +854,7 @@ namespace IPASS {
              * EN_DPL and ENAA_P0 to be HIGH
              * To change this value you first need to write COMMAND::ACTIVATE to the RF24L01
              */
-            [[maybe_unused]] static Setting DPL_P0;
+            [[maybe_unused]] static constexpr Setting DPL_P0 = {REGISTER::DYNPD, 0x01, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the EN_DPL-setting
@@ -749,7 +863,7 @@ namespace IPASS {
              * @note
              * To change this value you first need to write COMMAND::ACTIVATE to the RF24L01
              */
-            [[maybe_unused]] static Setting EN_DPL;
+            [[maybe_unused]] static constexpr Setting EN_DPL = {REGISTER::FEATURE, 0x04, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the EN_ACK_PAY-setting
@@ -758,7 +872,7 @@ namespace IPASS {
              * @note
              * To change this value you first need to write COMMAND::ACTIVATE to the RF24L01
              */
-            [[maybe_unused]] static Setting EN_ACK_PAY;
+            [[maybe_unused]] static constexpr Setting EN_ACK_PAY = {REGISTER::FEATURE, 0x02, false};
             /**
              * @brief
              * static Settings that contains the Register_name and the bitmask of the EN_DYN_ACK-setting
@@ -767,15 +881,256 @@ namespace IPASS {
              * @note
              * To change this value you first need to write COMMAND::ACTIVATE to the RF24L01
              */
-            [[maybe_unused]] static Setting EN_DYN_ACK;
+            [[maybe_unused]] static constexpr Setting EN_DYN_ACK = {REGISTER::FEATURE, 0x01, false};
+        };
+
+        /**
+         * @brief
+         * Struct pipe_config
+         * @details
+         * Struct with the configuration of one RX-pipe, used by configure_pipes()
+         */
+        struct pipe_config {
+            ///boolean that controls if the pipe is enabled (ERX_Px)
+            bool enabled;
+            ///uint8_t least significant byte of the address of the pipe, the other bytes are shared by all pipes
+            uint8_t address;
+            ///uint8_t amount of bytes in a payload on this pipe 1-32 (RX_PW_Px), not used with dynamic payload length
+            uint8_t width;
+            ///boolean that controls if auto acknowledgement is enabled on the pipe (ENAA_Px)
+            bool auto_ack;
+        };
+
+        /**
+         * @brief
+         * RAII-object that keeps a no-ack session open during its lifetime
+         * @details
+         * @code
+         * {
+         *     IPASS::RF24L01::no_ack_session session(chip);
+         *     for (auto &color : colors) {
+         *         chip.write_tx(color, true);
+         *         chip.send_packages();
+         *     }
+         * }
+         * @endcode
+         */
+        class no_ack_session {
+        private:
+            /**
+             * @brief
+             * the chip of the session
+             */
+            RF24L01 &chip;
+        public:
+            /**
+             * @brief
+             * constructor for no_ack_session, calls start_no_ack_session()
+             * @param chip the chip of the session
+             */
+            explicit no_ack_session(RF24L01 &chip);
+
+            no_ack_session(const no_ack_session &) = delete;
+
+            /**
+             * @brief
+             * destructor for no_ack_session, calls stop_no_ack_session()
+             */
+            ~no_ack_session();
+        };
+
+        /**
+         * @brief
+         * Struct link_statistics
+         * @details
+         * Struct with the counters of statistics(). The interrupt counters are counted when the interrupts are cleared,
+         * which every function that handles them already does, so they cost no SPI-transaction. The other counters are
+         * sampled with sample_link_statistics().
+         */
+        struct link_statistics {
+            ///uint32_t amount of cleared TX_DS interrupts, payloads that are send or acknowledged
+            uint32_t tx_ds;
+            ///uint32_t amount of cleared MAX_RT interrupts, payloads that reached the maximum amount of retransmits
+            uint32_t max_rt;
+            ///uint32_t amount of cleared RX_DR interrupts
+            uint32_t rx_dr;
+            ///uint32_t sum of the ARC_CNT of REGISTER::OBSERVE_TX at every sample, the retransmits of the last payload
+            uint32_t retransmits;
+            ///uint32_t increase of the PLOS_CNT of REGISTER::OBSERVE_TX, the payloads lost after the maximum retransmits
+            uint32_t lost;
+            ///uint32_t amount of samples with a full RX FIFO, in which the RF24L01 drops new payloads
+            uint32_t rx_full;
+            ///uint32_t amount of samples with a carrier on the channel (REGISTER::CD)
+            uint32_t carrier;
+            ///uint32_t amount of calls of sample_link_statistics()
+            uint32_t samples;
+        };
+
+#ifdef IPASS_LATENCY
+        /**
+         * @brief
+         * Struct latency_histograms
+         * @details
+         * Struct with the time in us of the calls of the entry points, see latency(). Only exists when IPASS_LATENCY is
+         * defined for every file of the build, it adds 3 Latency_Histogram objects of 1.3 kB to the RF24L01.
+         */
+        struct latency_histograms {
+            ///Latency_Histogram of read_rx()
+            Latency_Histogram<> read_rx;
+            ///Latency_Histogram of send_packages()
+            Latency_Histogram<> send_packages;
+            ///Latency_Histogram of write_tx()
+            Latency_Histogram<> write_tx;
+        };
+#endif //IPASS_LATENCY
+
+        /**
+         * @brief
+         * Struct profile
+         * @details
+         * Struct with everything to talk to one peer, used by switch_profile(). The address is used as TX_ADDR and as
+         * RX_ADDR_P0, so the acknowledgements of the peer are received on pipe 0. A profile can be constexpr:
+         * @code
+         * static constexpr IPASS::RF24L01::profile node_1 = {{0xe7, 0xe7, 0xe7, 0xe7, 0x01}, 0x11, 5, false, 3, 0, 3};
+         * @endcode
+         */
+        struct profile {
+            ///std::array<uint8_t, 5> address of the peer, in the byte order of change_ADDR()
+            std::array<uint8_t, 5> address;
+            ///uint8_t rf-channel 0-127
+            uint8_t channel;
+            ///uint8_t amount of bytes in a payload on pipe 0 1-32 (RX_PW_P0)
+            uint8_t width;
+            ///boolean that controls if the data rate is 1 or 2 Mbps (RF_DR)
+            bool data_rate;
+            ///uint8_t output power 0-3, see change_rf_pwr()
+            uint8_t power;
+            ///uint8_t auto retransmit delay 0-15, see change_ard()
+            uint8_t ard;
+            ///uint8_t maximum amount of retransmits 0-15, see change_arc()
+            uint8_t arc;
+        };
+
+    private:
+        /**
+         * @brief
+         * profile that is on the chip, only used if profile_known is true
+         */
+        profile current_profile = {};
+
+        /**
+         * @brief
+         * boolean that indicates if current_profile is on the chip, any other write to its registers clears it
+         */
+        bool profile_known = false;
+
+        /**
+         * @brief
+         * counters of statistics()
+         */
+        link_statistics stats = {};
+
+#ifdef IPASS_LATENCY
+        /**
+         * @brief
+         * histograms of latency()
+         */
+        latency_histograms latency_us = {};
+#endif //IPASS_LATENCY
+
+        /**
+         * @brief
+         * PLOS_CNT at the last sample_link_statistics(), writing REGISTER::RF_CH sets PLOS_CNT to 0
+         */
+        uint8_t last_plos = 0;
+
+        /**
+         * @brief
+         * Private function to write the bytes of an address register up to the last byte that changes
+         * @details
+         * The RF24L01 writes an address least significant byte first and keeps the bytes that are not clocked in, so
+         * a peer that only differs in the least significant byte costs a transaction of 2 bytes
+         * @param register_address uint8_t that contains the address of the register
+         * @param old_address std::array<uint8_t, 5> with the address on the chip
+         * @param new_address std::array<uint8_t, 5> with the new address
+         */
+        void write_address_change(const uint8_t &register_address, const std::array<uint8_t, 5> &old_address,
+                                  const std::array<uint8_t, 5> &new_address);
+
+        /**
+         * @brief
+         * Private function to write the CE pin and to remember its level for set_channel()
+         * @param level boolean that's true for CE high
+         */
+        void write_CE(bool level);
+
+        /**
+         * @brief
+         * Private function to read the payload at the head of the RX FIFO
+         * @details
+         * The STATUS byte clocked out with the command tells if there is a payload, the payload bytes are only clocked
+         * when there is one, so an empty RX FIFO costs a transaction of 1 byte, or 2 with dynamic payload length.
+         * Without dynamic payload length the pipe decoded from that STATUS byte gives the width of the payload, so
+         * pipes with different widths are read with the same transaction.
+         * @param data buffer of 32 bytes the payload is read into
+         * @param size payload width of the pipes without dynamic payload length whose width is not written by this
+         * driver, and the maximum width of the other pipes, 1-32
+         * @param pipe the pipe of the payload is stored in this parameter
+         * @param length the amount of bytes of the payload is stored in this parameter
+         * @return boolean that's true if a payload is read
+         */
+        bool read_next(uint8_t data[], size_t size, uint8_t &pipe, uint8_t &length);
+
+        /**
+         * @brief
+         * Private function to flush the TX FIFO and count the payloads that were in it
+         * @details
+         * FIFO_STATUS only tells if the TX FIFO is empty or full, so with 1 or 2 payloads a filler payload is written
+         * first: the STATUS byte after it has TX_FULL set when there were 2. CE has to be low, so the filler is not
+         * send. Costs 1 SPI-transaction for an empty or full FIFO, 3 otherwise, plus the flush.
+         * @return size_t amount of payloads that were in the TX FIFO, 0-3
+         */
+        size_t flush_tx_count();
+
+    public:
+
+        /**
+         * @brief
+         * Struct stream_result
+         * @details
+         * Struct with the result of stream_tx()
+         */
+        struct stream_result {
+            ///size_t that contains the amount of payloads that are send, payloads 0 up to sent are acknowledged
+            size_t sent;
+            ///boolean that indicates if a payload failed because of MAX_RT or a timeout
+            bool failed;
+            ///size_t that contains the index of the payload that failed, only valid if failed is true
+            size_t failed_index;
+        };
+
+        /**
+         * @brief
+         * Struct received_payload
+         * @details
+         * Struct with a payload of drain_rx()
+         */
+        struct received_payload {
+            ///uint8_t that contains the pipe 0-5 the payload is received on
+            uint8_t pipe;
+            ///uint8_t that contains the amount of bytes in data
+            uint8_t length;
+            ///std::array<uint8_t, 32> with the payload, data[0] is the first byte
+            std::array<uint8_t, 32> data;
         };
 
         /**
          * @brief
          * Default constructor for RF24L01
          * @details
-         * Default constructor for the RF24L01
-         * @param bus hwlib::spi_bus_bit_banged_sclk_mosi_miso object that contains the spi_bus for the RF24L01
+         * Default constructor for the RF24L01. Any hwlib::spi_bus works, a hardware SPI-bus of the target is much faster
+         * than hwlib::spi_bus_bit_banged_sclk_mosi_miso
+         * @param bus hwlib::spi_bus object that contains the spi_bus for the RF24L01
          * @param modusPin hwlib::pin_out object that controls the CE-pin of the RF24L01
          * @param minion_select hwlib::pin_out object that controls the Chip select of the RF24L01
          * @param IRQ hwlib::pin_out object that is connected to IRQ-pin of the RF24L01
@@ -786,7 +1141,7 @@ namespace IPASS {
          * @param CRC boolean that controls of CRC is enabled or disabled
          * @param CRC_width that controls of CRC is 1 or 2 bytes
          */
-        RF24L01(hwlib::spi_bus_bit_banged_sclk_mosi_miso &bus,
+        RF24L01(hwlib::spi_bus &bus,
                 hwlib::pin_out &modusPin,
                 hwlib::pin_out &minion_select,
                 hwlib::pin_in &IRQ,
@@ -797,6 +1152,61 @@ namespace IPASS {
                 bool CRC = true,
                 bool CRC_width = true);
 
+        /**
+         * @brief
+         * constructor for RF24L01 that leaves the chip untouched
+         * @details
+         * Use apply() with a RF24L01_Config to configure the chip, that costs one SPI-transaction per register and no
+         * reads, where the other constructor reads and writes many registers
+         * @param bus hwlib::spi_bus object that contains the spi_bus for the RF24L01
+         * @param modusPin hwlib::pin_out object that controls the CE-pin of the RF24L01
+         * @param minion_select hwlib::pin_out object that controls the Chip select of the RF24L01
+         * @param IRQ hwlib::pin_out object that is connected to IRQ-pin of the RF24L01
+         */
+        RF24L01(hwlib::spi_bus &bus,
+                hwlib::pin_out &modusPin,
+                hwlib::pin_out &minion_select,
+                hwlib::pin_in &IRQ);
+
+        /**
+         * @brief
+         * function to write a complete configuration to the chip
+         * @details
+         * Puts the CE-pin low and writes every register of the configuration once, without reading a register first:
+         * the addresses, the pipes, the retransmit settings, the channel, RF_SETUP, FEATURE and DYNPD (after
+         * COMMAND::ACTIVATE if needed), STATUS to clear the interrupts and CONFIG as the last one, so the chip powers up
+         * with the complete configuration. The address and payload width of a disabled pipe are left out, just like
+         * FEATURE and DYNPD when the features are not active and not used by the configuration. The configuration is
+         * not checked, use apply<config>() to check it at compile time.
+         * @param config RF24L01_Config with the register image
+         */
+        [[maybe_unused]] void apply(const RF24L01_Config &config);
+
+        /**
+         * @brief
+         * function to check a configuration at compile time and write it to the chip
+         * @details
+         * Every check of RF24L01_Config is a static_assert with its own message, and valid() is asserted last, so an
+         * invalid configuration doesn't compile:
+         * @code
+         * static constexpr IPASS::RF24L01_Config config = IPASS::RF24L01_Config().channel(0x11).pipe(0, true, 5);
+         * chip.apply<config>();
+         * @endcode
+         * @tparam config RF24L01_Config with static storage duration, like a constexpr variable at namespace scope
+         */
+        template<const auto &config>
+        [[maybe_unused]] void apply() {
+            static_assert(config.valid_address_and_channel(), "the address width must be 3-5 and the channel 0-127");
+            static_assert(config.valid_crc(), "auto acknowledgement needs the CRC");
+            static_assert(config.valid_payload_widths(), "the payload width of a pipe must be 0-32");
+            static_assert(config.valid_features(), "dynamic payloads need auto acknowledgement and EN_DPL, "
+                                                   "acknowledgement payloads need dynamic payloads");
+            static_assert(config.valid_pipe_numbers(), "the pipe number must be 0-5");
+            static_assert(config.valid_retries(), "the retransmit delay and count must be 0-15");
+            static_assert(config.valid(), "RF24L01_Config::valid() has a check without a static_assert here");
+            apply(config);
+        }
+
         /**
          * @brief
          * function to change to value in the address-register
@@ -896,16 +1306,200 @@ namespace IPASS {
          */
         [[maybe_unused]] void change_RX_PW_P(const uint8_t &pipe, const uint8_t &value);
 
+        /**
+         * @brief
+         * function to configure all 6 RX-pipes at once
+         * @details
+         * Writes REGISTER::EN_RXADDR, REGISTER::EN_AA, the address and the payload width of every enabled pipe. The
+         * RF24L01 only compares the least significant byte of the addresses of pipes 2-5 and uses the other bytes of
+         * pipe 1, so all pipes get the address of base_address with their own least significant byte.
+         * @note
+         * Pipe 0 is also used to receive the acknowledgements in TX-mode, so its address must be the TX_ADDR of the
+         * transmitter it acknowledges
+         * @param base_address std::array<uint8_t, 5> with the address, the last byte is replaced by the byte of the pipe
+         * @param pipes std::array of 6 pipe_config with the configuration of pipe 0-5
+         */
+        [[maybe_unused]] void configure_pipes(const std::array<uint8_t, 5> &base_address,
+                                              const std::array<pipe_config, 6> &pipes);
+
+        /**
+         * @brief
+         * function to disable dynamic payload length
+         * @details
+         * Clears REGISTER::DYNPD and SETTING::EN_DPL, read_rx() with a buffer uses the pipe width again
+         */
+        [[maybe_unused]] void disable_dynamic_payloads();
+
+        /**
+         * @brief
+         * function to read all payloads in the RX FIFO into a buffer
+         * @details
+         * Reads payloads until the STATUS byte of a read reports an empty RX FIFO, then clears RX_DR once. The STATUS
+         * byte of that clear is checked again, so a payload that arrives during the drain is read as well. N payloads
+         * cost N + 2 SPI-transactions, 2N + 2 with dynamic payload length, and no FIFO_STATUS reads. When the buffer is full the rest stays in the RX FIFO
+         * and RX_DR stays set. Without dynamic payload length a pipe whose width is written by this driver, for
+         * example with configure_pipes() or apply(), is read with its own width.
+         * @param payloads buffer for the payloads
+         * @param capacity amount of payloads that fit in the buffer
+         * @param size payload width of the other pipes without dynamic payload length, 1-32, default value = 32
+         * @return size_t amount of payloads read into payloads
+         */
+        [[maybe_unused]] size_t drain_rx(received_payload payloads[], size_t capacity, size_t size = 32);
+
+        /**
+         * @brief
+         * function to hand all payloads in the RX FIFO to a callback
+         * @details
+         * Reads the payloads like drain_rx() with a buffer, the callback is called for every payload with the pipe, a
+         * pointer to the payload and its length: handler(uint8_t pipe, const uint8_t data[], size_t length)
+         * @param handler the callback
+         * @param size payload width of the other pipes without dynamic payload length, 1-32, default value = 32
+         * @return size_t amount of payloads handed to the callback
+         */
+        template<typename handler_type>
+        [[maybe_unused]] size_t drain_rx(handler_type handler, size_t size = 32) {
+            size_t drained = 0;
+            uint8_t data[32] = {};
+            uint8_t pipe = 0;
+            uint8_t length = 0;
+            for (;;) {
+                while (read_next(data, size, pipe, length)) {
+                    handler(pipe, static_cast<const uint8_t *>(data), size_t(length));
+                    drained++;
+                }
+                register_write(REGISTER::STATUS, SETTING::RX_DR.Mask);
+                if (last_pipe() == 0x07) {
+                    return drained;
+                }
+            }
+        }
+
+        /**
+         * @brief
+         * function to enable dynamic payload length
+         * @details
+         * Writes COMMAND::ACTIVATE when the features are not active, enables SETTING::EN_DPL and the DPL_Px and ENAA_Px
+         * settings of the pipes. With dynamic payload length a payload is send with the length given to write_tx() and
+         * the receiver reads that length with read_payload_width(), so short payloads are not padded to the pipe width.
+         * Both the transmitter and the receiver need dynamic payload length enabled.
+         * @param pipes bitmask of the pipes that use dynamic payload length, bit 0 is pipe 0, default value = all pipes
+         */
+        [[maybe_unused]] void enable_dynamic_payloads(uint8_t pipes = 0x3F);
+
+        /**
+         * @brief
+         * function to enable acknowledgement payloads
+         * @details
+         * Enables dynamic payload length on the pipes and on pipe 0, which receives the acknowledgements in TX-mode, and
+         * sets SETTING::EN_ACK_PAY. The receiver loads a reply with write_ack_payload() that is send with the
+         * acknowledgement of the next payload on that pipe, the transmitter reads it with read_ack_payload(). Both the
+         * transmitter and the receiver need acknowledgement payloads enabled.
+         * @param pipes bitmask of the pipes that send acknowledgement payloads, default value = all pipes
+         */
+        [[maybe_unused]] void enable_ack_payloads(uint8_t pipes = 0x3F);
+
+        /**
+         * @brief
+         * function to check if dynamic payload length is enabled
+         * @return boolean that's true after enable_dynamic_payloads() and false after disable_dynamic_payloads()
+         */
+        [[maybe_unused]] bool dynamic_payloads_enabled() const;
+
         /**
          * @brief
          * function flush the RX and TX payload registers
          */
         [[maybe_unused]] void flush_rx_tx();
 
+        /**
+         * @brief
+         * function to check if the RF24L01 has an interrupt pending
+         * @details
+         * Reads the IRQ-pin, which is active low, so it costs no SPI-transaction. The pin stays low until the flag is
+         * cleared, also during a session of start_no_ack_session() that leaves TX_DS set
+         * @return boolean that's true if RX_DR, TX_DS or MAX_RT is set and not masked
+         */
+        [[maybe_unused]] bool interrupt_pending();
+
+        /**
+         * @brief
+         * function to forget the content of the shadow registers
+         * @details
+         * The next read of every configuration register is done on the chip again. Call this function after the chip
+         * lost its configuration (for example after a brown-out) while the shadow registers are enabled
+         */
+        [[maybe_unused]] void invalidate_shadow_registers();
+
+        /**
+         * @brief
+         * Function to get the STATUS register without an extra SPI-transaction
+         * @details
+         * The RF24L01 clocks out the STATUS register as first byte of every SPI-command, this function returns the
+         * copy of that byte from the last transaction. The byte contains:
+         * - bit 6: RX_DR, data ready in the RX FIFO
+         * - bit 5: TX_DS, data send from the TX FIFO
+         * - bit 4: MAX_RT, maximum number of retransmits reached
+         * - bit 3-1: RX_P_NO, pipe number of the payload in the RX FIFO, 0x07 if the RX FIFO is empty
+         * - bit 0: TX_FULL, TX FIFO full
+         * @note
+         * The value is the status at the start of the last transaction, use update_status() for a fresh value
+         * @return uint8_t that contains the STATUS register
+         */
+        [[maybe_unused]] uint8_t last_status() const;
+
+        /**
+         * @brief
+         * Function to read a setting of the STATUS register without an extra SPI-transaction
+         * @details
+         * Reads a setting from the copy of the STATUS register, see last_status()
+         * @param registerFunction SETTING::Setting of REGISTER::STATUS like SETTING::RX_DR, SETTING::TX_DS or SETTING::MAX_RT
+         * @return returns true if the bits of the setting are high
+         */
+        [[maybe_unused]] bool last_status(const SETTING::Setting &registerFunction) const;
+
+        /**
+         * @brief
+         * Function to get the RX_P_NO-value of the last STATUS byte
+         * @return uint8_t 0-5 with the pipe of the payload that's available in the RX FIFO or 0x07 if the RX FIFO is empty
+         */
+        [[maybe_unused]] uint8_t last_pipe() const;
+
+        /**
+         * @brief
+         * Function to get the TX_FULL-bit of the last STATUS byte
+         * @return boolean value that indicates if the TX FIFO was full at the last transaction
+         */
+        [[maybe_unused]] bool last_tx_full() const;
+
+#ifdef IPASS_LATENCY
+        /**
+         * @brief
+         * function to get the time of the calls of write_tx(), send_packages() and read_rx()
+         * @details
+         * Only with IPASS_LATENCY, see print_latency() for a dump to the console
+         * @return latency_histograms with the times since the construction or reset_statistics()
+         */
+        [[maybe_unused]] const latency_histograms &latency() const;
+#endif //IPASS_LATENCY
+
+        /**
+         * @brief
+         * Function to write a payload to the TX FIFO without clearing the interrupt flags
+         * @details
+         * One SPI-transaction, for a caller that tracks TX_DS and MAX_RT itself like RF24L01_Async_TX. write_tx()
+         * clears the flags, so a TX_DS of a payload that's still tracked would be lost.
+         * @param data buffer that contains the payload, data[0] is send first
+         * @param length amount of bytes in the payload, 1-32
+         * @return boolean that's false if the TX FIFO was full and the payload is not written
+         */
+        [[maybe_unused]] bool load_tx(const uint8_t data[], size_t length);
+
         /**
          * @brief
          * boolean to check if a packet is received
-         * @return boolean value that indicates if there is a packet by reading the RX_EMPTY bit in register FIFO_STATUS
+         * @details
+         * Uses the RX_P_NO-value of the STATUS byte clocked out by a COMMAND::NOP, which costs one byte on the SPI-bus
+         * @return boolean value that indicates if there is a packet in the RX FIFO
          */
         [[maybe_unused]] bool packet_received();
 
@@ -916,6 +1510,15 @@ namespace IPASS {
          */
         [[maybe_unused]] bool packet_send();
 
+#ifdef IPASS_LATENCY
+        /**
+         * @brief
+         * function to print the histograms of latency() with a header, one line per entry point
+         * @param out the stream to print to, default value = hwlib::cout
+         */
+        [[maybe_unused]] void print_latency(hwlib::ostream &out = hwlib::cout) const;
+#endif //IPASS_LATENCY
+
         /**
          * @brief
          * Function to read received packages
@@ -925,9 +1528,47 @@ namespace IPASS {
          */
         template<size_t amount>
         [[maybe_unused]] void read_rx(std::array<uint8_t, amount> &Data) {
+#ifdef IPASS_LATENCY
+            IPASS_LATENCY_SCOPE(latency_us.read_rx);
+#endif
             read(COMMAND::R_RX_PAYLOAD, Data);
         }
 
+        /**
+         * @brief
+         * Function to read a received payload directly into a buffer
+         * @details
+         * With dynamic payload length the length of the payload is read with read_payload_width(), otherwise size bytes
+         * are read. No temporary copy is made, data[0] is the first byte of the payload. Bytes of the payload that don't
+         * fit in the buffer are discarded.
+         * @param data buffer the payload is read into
+         * @param size size of the buffer, 1-32 bytes
+         * @return size_t with the amount of bytes read into data, 0 if there was no valid payload
+         */
+        [[maybe_unused]] size_t read_rx(uint8_t data[], size_t size);
+
+        /**
+         * @brief
+         * Function to read an acknowledgement payload on the transmitter
+         * @details
+         * After TX_DS the acknowledgement payload of the receiver is in the RX FIFO on pipe 0, this function reads it
+         * like read_rx() and clears RX_DR
+         * @param data buffer the acknowledgement payload is read into
+         * @param size size of the buffer, 1-32 bytes
+         * @return size_t with the amount of bytes read into data, 0 if there was no acknowledgement payload
+         */
+        [[maybe_unused]] size_t read_ack_payload(uint8_t data[], size_t size);
+
+        /**
+         * @brief
+         * Function to read the width of the payload at the front of the RX FIFO
+         * @details
+         * Uses COMMAND::R_RX_PL_WID, only valid when dynamic payload length is enabled. A width above 32 means a
+         * corrupted payload, in that case the RX FIFO is flushed.
+         * @return uint8_t with the width of the payload 1-32, 0 if the payload was corrupted
+         */
+        [[maybe_unused]] uint8_t read_payload_width();
+
         /**
          * @brief
          * Function to read multiple uint8_t value from an register
@@ -1019,6 +1660,22 @@ namespace IPASS {
          */
         [[maybe_unused]] void reset_RX_PW_P(const uint8_t &pipe);
 
+        /**
+         * @brief
+         * function to set the counters of statistics() to 0, and with IPASS_LATENCY the histograms of latency()
+         */
+        [[maybe_unused]] void reset_statistics();
+
+        /**
+         * @brief
+         * function to sample the link quality into statistics()
+         * @details
+         * Reads REGISTER::OBSERVE_TX, REGISTER::CD and REGISTER::FIFO_STATUS, 3 SPI-transactions. ARC_CNT is the amount
+         * of retransmits of the last payload, so call this function once after every payload to count all retransmits,
+         * or less often to get a sample of them. PLOS_CNT stops at 15 until REGISTER::RF_CH is written.
+         */
+        [[maybe_unused]] void sample_link_statistics();
+
         /**
          * @brief
          * function that transmits the packages stored in the transmit buffer
@@ -1029,8 +1686,10 @@ namespace IPASS {
          * @brief
          * function to change the RF-channel of the RF24L01
          * @details
-         * Actual RF-frequency is 2400+value[MHz]
-         * @param channel the new channel value the maximum value is 128
+         * Actual RF-frequency is 2400+value[MHz]. REGISTER::RF_CH should only be written in standby, so when CE is
+         * high, for example in RX-mode, CE is pulsed low around the write. That costs 2 pin writes and no extra
+         * SPI-transaction, the RF24L01 listens again 130 us after CE is high.
+         * @param channel the new channel value the maximum value is 127
          */
         [[maybe_unused]] void set_channel(uint8_t channel);
 
@@ -1043,6 +1702,21 @@ namespace IPASS {
         */
         [[maybe_unused]] void setting_disable(SETTING::Setting registerFunction);
 
+        /**
+         * @brief
+         * Function to disable a setting that's known at compile time
+         * @details
+         * The register and mask are template arguments, so the call is one masked read-modify-write of a constant
+         * register address, for example setting_disable<SETTING::PRIM_RX>()
+         * @tparam setting SETTING::Setting constant that contains the register and mask of the setting
+         */
+        template<const SETTING::Setting &setting>
+        [[maybe_unused]] void setting_disable() {
+            static_assert(setting.REGISTER_ADDR != REGISTER::FIFO_STATUS and setting.REGISTER_ADDR != REGISTER::CD,
+                          "the setting is in a read-only register");
+            register_write(setting.REGISTER_ADDR, register_read(setting.REGISTER_ADDR) & ~setting.Mask);
+        }
+
 
         /**
         * @brief
@@ -1053,6 +1727,21 @@ namespace IPASS {
         */
         [[maybe_unused]] void setting_enable(SETTING::Setting registerFunction);
 
+        /**
+         * @brief
+         * Function to enable a setting that's known at compile time
+         * @details
+         * The register and mask are template arguments, so the call is one masked read-modify-write of a constant
+         * register address, for example setting_enable<SETTING::PWR_UP>()
+         * @tparam setting SETTING::Setting constant that contains the register and mask of the setting
+         */
+        template<const SETTING::Setting &setting>
+        [[maybe_unused]] void setting_enable() {
+            static_assert(setting.REGISTER_ADDR != REGISTER::FIFO_STATUS and setting.REGISTER_ADDR != REGISTER::CD,
+                          "the setting is in a read-only register");
+            register_write(setting.REGISTER_ADDR, register_read(setting.REGISTER_ADDR) | setting.Mask);
+        }
+
         /**
          * @brief
          * Function to read the current status if a setting
@@ -1062,6 +1751,17 @@ namespace IPASS {
          */
         [[maybe_unused]] bool setting_read(SETTING::Setting registerFunction);
 
+        /**
+         * @brief
+         * Function to read the current status of a setting that's known at compile time
+         * @tparam setting SETTING::Setting constant that contains the register and mask of the setting
+         * @return boolean that's true if the setting is enabled
+         */
+        template<const SETTING::Setting &setting>
+        [[maybe_unused]] bool setting_read() {
+            return (register_read(setting.REGISTER_ADDR) & setting.Mask) == setting.Mask;
+        }
+
         /**
          * @brief
          * Function to reset a setting
@@ -1071,18 +1771,150 @@ namespace IPASS {
          */
         [[maybe_unused]] void setting_reset(SETTING::Setting registerFunction);
 
+        /**
+         * @brief
+         * Function to reset a setting that's known at compile time to its reset value
+         * @tparam setting SETTING::Setting constant that contains the register, mask and the standard value of the setting
+         */
+        template<const SETTING::Setting &setting>
+        [[maybe_unused]] void setting_reset() {
+            if constexpr (setting.Reset_Value) {
+                setting_enable<setting>();
+            } else {
+                setting_disable<setting>();
+            }
+        }
+
+        /**
+         * @brief
+         * function to start a session of payloads without acknowledgement
+         * @details
+         * Writes COMMAND::ACTIVATE when the features are not active and sets SETTING::EN_DYN_ACK once. Until
+         * stop_no_ack_session() every write_tx() with no_ack is one COMMAND::W_TX_PAYLOAD_NO_ACK transaction, instead of
+         * toggling the features around every payload. The receiver needs no setting for these payloads. Starting an
+         * open session does nothing.
+         * @note
+         * write_tx() doesn't clear TX_DS in a session, so after the first payload TX_DS stays set and holds the IRQ-pin
+         * low until a write_tx() with ack or a write of REGISTER::STATUS clears it. A poller of interrupt_pending(), like
+         * RF24L01_RX_Engine::poll() or RF24L01_Async_TX::poll(), then sees an interrupt on every call and does its SPI
+         * reads each time.
+         */
+        [[maybe_unused]] void start_no_ack_session();
+
         /**
          * @brief
          * function to start the receiving mode on the RF24L01
          */
         [[maybe_unused]] void start_RX();
 
+        /**
+         * @brief
+         * function to start the streaming transmit mode on the RF24L01
+         * @details
+         * Powers the RF24L01 up in TX-mode, clears the interrupts and holds CE high, so every payload written to the
+         * TX FIFO is send directly after the previous one without a CE pulse per payload
+         */
+        [[maybe_unused]] void start_TX_stream();
+
+        /**
+         * @brief
+         * function to get the link statistics
+         * @return link_statistics with the counters since the construction or reset_statistics()
+         */
+        [[maybe_unused]] const link_statistics &statistics() const;
+
+        /**
+         * @brief
+         * function to stop a session started with start_no_ack_session()
+         * @details
+         * Clears SETTING::EN_DYN_ACK and writes COMMAND::ACTIVATE again if the session changed them, so the features are
+         * as before the session. Stopping without an open session does nothing.
+         */
+        [[maybe_unused]] void stop_no_ack_session();
+
         /**
         * @brief
         * function to stop the receiving mode on the RF24L01
         */
         [[maybe_unused]] void stop_RX();
 
+        /**
+         * @brief
+         * function to stop the streaming transmit mode on the RF24L01
+         * @details
+         * Sets CE low, payloads that are still in the TX FIFO stay there
+         */
+        [[maybe_unused]] void stop_TX_stream();
+
+        /**
+         * @brief
+         * Function to send a sequence of payloads back-to-back
+         * @details
+         * Keeps the TX FIFO full while CE is held high. Every pass reads the STATUS byte with a COMMAND::NOP and writes
+         * a payload when TX_FULL is low, so the FIFO is refilled even when TX_DS flags merged. The STATUS byte of a
+         * write is clocked out before the payload is added, so it can't tell if the FIFO is full after the write. TX_DS
+         * of the STATUS byte counts the acknowledged payloads. TX_DS is one bit, so payloads that are acknowledged
+         * between two polls, for example while an interrupt runs, count as one. When
+         * MAX_RT is set or the timeout passes, the payloads that are still in the TX FIFO are counted and flushed: the
+         * failed payload is the oldest of them, so failed_index is exact even when TX_DS flags merged. The payloads from
+         * failed_index on can be send again. The RF24L01 is left in TX-mode with CE low.
+         * @tparam payloads_type container of std::array<uint8_t, amount>, for example a std::array of payloads
+         * @param payloads the payloads to send in order
+         * @param timeout_us maximum time in μs to wait for the acknowledgement of one payload, default value = 100 ms
+         * @return stream_result with the amount of payloads that are send and the index of the payload that failed
+         */
+        template<typename payloads_type>
+        [[maybe_unused]] stream_result stream_tx(const payloads_type &payloads, uint_fast64_t timeout_us = 100'000) {
+            const size_t amount = payloads.size();
+            size_t written = 0;
+            size_t completed = 0;
+            start_TX_stream();
+            uint_fast64_t deadline = hwlib::now_us() + timeout_us;
+            while (completed < amount) {
+                if (written < amount) {
+                    update_status();
+                } else {
+                    // all payloads are written, FIFO_STATUS tells when the last one left the FIFO
+                    if (register_read(REGISTER::FIFO_STATUS) & SETTING::TX_EMPTY.Mask) {
+                        completed = written;
+                    }
+                }
+                const uint8_t flags = status & 0x30;
+                if (flags) {
+                    register_write(REGISTER::STATUS, flags);
+                }
+                if ((flags & SETTING::TX_DS.Mask) and completed < written) {
+                    completed++;
+                    deadline = hwlib::now_us() + timeout_us;
+                }
+                if ((flags & SETTING::MAX_RT.Mask) or hwlib::now_us() > deadline) {
+                    stop_TX_stream();
+                    // the failed payload is the oldest in the FIFO, the payloads before it are acknowledged
+                    const size_t failed_index = written - flush_tx_count();
+                    return {failed_index, true, failed_index};
+                }
+                // the STATUS byte of this pass is read after the last write, so its TX_FULL is the current FIFO
+                if (written < amount and not last_tx_full()) {
+                    write(COMMAND::W_TX_PAYLOAD, payloads[written]);
+                    written++;
+                }
+            }
+            stop_TX_stream();
+            return {completed, false, 0};
+        }
+
+        /**
+         * @brief
+         * function to switch to the profile of another peer
+         * @details
+         * Writes only the registers that differ from the profile on the chip: TX_ADDR and RX_ADDR_P0 up to the last
+         * byte that changes, RF_CH, RX_PW_P0, RF_SETUP and SETUP_RETR. Without reads, a switch between peers that only
+         * differ in the least significant address byte costs two transactions of 2 bytes. The first switch, and the
+         * first switch after a register of the profile is changed with another function or after
+         * invalidate_shadow_registers(), writes all registers. apply() also sets the profile on the chip.
+         * @param new_profile profile with the peer
+         */
+        [[maybe_unused]] void switch_profile(const profile &new_profile);
 
         /**
          * @brief
@@ -1094,6 +1926,27 @@ namespace IPASS {
         [[maybe_unused]] bool test();
 
 
+        /**
+         * @brief
+         * Function to refresh the copy of the STATUS register
+         * @details
+         * Writes a COMMAND::NOP which is a single byte SPI-transaction, the STATUS register is clocked out during that byte
+         * @return uint8_t that contains the STATUS register, see last_status() for the meaning of the bits
+         */
+        [[maybe_unused]] uint8_t update_status();
+
+        /**
+         * @brief
+         * function to enable or disable the shadow registers
+         * @details
+         * When enabled the driver keeps a copy of the configuration registers (REGISTER::CONFIG through REGISTER::FEATURE)
+         * which is updated by every register write. Reading a configuration register, and with that every
+         * setting_enable(), setting_disable(), change_arc() and similar read-modify-write function, only costs a
+         * SPI-transaction the first time the register is used. The status registers are always read from the chip.
+         * @param enable boolean that controls if the shadow registers are used, default value = true
+         */
+        [[maybe_unused]] void use_shadow_registers(bool enable = true);
+
         /**
          * @brief
          * Write one single command without value to the RF24L01
@@ -1107,31 +1960,72 @@ namespace IPASS {
          * @brief
          * Function to write data to TX_PLD
          * @details
-         * The function does also always check if IRQ is active high and if that's true if resets IRQ to disable the lock
+         * The STATUS byte returned while writing the payload is used to clear the RX_DR, TX_DS and MAX_RT interrupts
+         * that are set, a set MAX_RT would otherwise lock the transmission of the payload. In a session of
+         * start_no_ack_session() a payload without ack is one SPI-transaction and only MAX_RT is cleared, so TX_DS and
+         * RX_DR stay set and hold the IRQ-pin low, see start_no_ack_session().
          * @tparam amount variable that controls the size of std::array Data
          * @param Data std::array uint8_t that written to the TX_PLD register
          * @param no_ack boolean that controls if the data is written with or without acknowledgement
          */
         template<size_t amount>
         [[maybe_unused]] void write_tx(std::array<uint8_t, amount> &Data, bool no_ack = false) {
-            if(!IRQ.read()){
-                register_write(REGISTER::STATUS, 0x70);
+#ifdef IPASS_LATENCY
+            IPASS_LATENCY_SCOPE(latency_us.write_tx);
+#endif
+            if (no_ack and dynamic_ack) {
+                write(COMMAND::W_TX_PAYLOAD_NO_ACK, Data);
+                // TX_DS is left set, a payload without ack can't set MAX_RT
+                if (status & SETTING::MAX_RT.Mask) {
+                    register_write(REGISTER::STATUS, SETTING::MAX_RT.Mask);
+                }
+                return;
             }
             if (no_ack) {
                 bool prev_active = Active;
                 if(!prev_active) {
                     write_command(COMMAND::ACTIVATE);
                 }
-                setting_enable(SETTING::EN_DYN_ACK);
+                setting_enable<SETTING::EN_DYN_ACK>();
                 write(COMMAND::W_TX_PAYLOAD_NO_ACK, Data);
-                setting_disable(SETTING::EN_DYN_ACK);
+                setting_disable<SETTING::EN_DYN_ACK>();
                 if(!prev_active) {
                     write_command(COMMAND::ACTIVATE);
                 }
             } else {
                 write(COMMAND::W_TX_PAYLOAD, Data);
             }
+            if (status & 0x70) {
+                register_write(REGISTER::STATUS, status & 0x70);
+            }
         }
+
+        /**
+         * @brief
+         * Function to load an acknowledgement payload on the receiver
+         * @details
+         * Uses COMMAND::W_ACK_PAYLOAD, the payload is send with the acknowledgement of the next payload received on the
+         * pipe. The acknowledgement payloads share the 3 payload deep TX FIFO, see RF24L01_Ack_Channel for a queue per
+         * pipe. data[0] is the first byte of the payload.
+         * @param pipe the pipe 0-5
+         * @param data buffer that contains the payload
+         * @param length amount of bytes in the payload, 1-32
+         * @return boolean that's false if the TX FIFO was full and the payload is not loaded
+         */
+        [[maybe_unused]] bool write_ack_payload(uint8_t pipe, const uint8_t data[], size_t length);
+
+        /**
+         * @brief
+         * Function to write a payload directly from a buffer to TX_PLD
+         * @details
+         * No temporary copy is made, data[0] is the first byte of the payload. With dynamic payload length the payload
+         * is send with length bytes, otherwise the receiver reads the width of its pipe. Interrupts are cleared like
+         * the other write_tx().
+         * @param data buffer that contains the payload
+         * @param length amount of bytes in the payload, 1-32
+         * @param no_ack boolean that controls if the data is written with or without acknowledgement
+         */
+        [[maybe_unused]] void write_tx(const uint8_t data[], size_t length, bool no_ack = false);
     };
 } //namespace IPASS
 #endif //IPASS_RF24L01_H
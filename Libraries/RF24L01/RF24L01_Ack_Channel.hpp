@@ -0,0 +1,193 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Ack_Channel.hpp
+ *  @brief     IPASS-project: Queue per pipe of acknowledgement payloads for the RF24L01.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_ACK_CHANNEL_H
+#define IPASS_RF24L01_ACK_CHANNEL_H
+
+#include "RF24L01.hpp"
+#include "../Ring_Buffer/Ring_Buffer.hpp"
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Return channel of a receiver that answers with acknowledgement payloads
+     * @details
+     * A reply that's loaded in the RF24L01 goes back to the transmitter with the acknowledgement of the next payload on
+     * its pipe, without switching PRIM_RX on both ends. A reply that's computed from request N is loaded after request
+     * N is acknowledged, so it goes back with the acknowledgement of request N + 1: the transmitter sends a request and
+     * reads the reply of the request before it. The acknowledgement payloads share the 3 payload deep TX FIFO of the
+     * RF24L01, so the channel keeps a Ring_Buffer of replies per pipe and loads one reply per pipe in the RF24L01. Call
+     * payload_received() for every payload that's read from a pipe. It reads REGISTER::FIFO_STATUS to check if the
+     * loaded reply of that pipe went out: a reply that's loaded after the RF24L01 acknowledged the payload is still in
+     * the TX FIFO and stays loaded. With replies loaded on 2 or more pipes and a TX FIFO that's neither empty nor full
+     * the FIFO can't tell which reply went out, then the reply of the pipe of the payload counts as send, which is
+     * right when payload_received() is called before queue() of the reply. Both ends need
+     * RF24L01::enable_ack_payloads(), the transmitter reads the replies with RF24L01::read_ack_payload().
+     * @tparam payload_size the maximum amount of bytes in a reply, 1-32
+     * @tparam depth the amount of replies the queue of one pipe can store, must be a power of 2
+     */
+    template<size_t payload_size, size_t depth>
+    class RF24L01_Ack_Channel {
+        static_assert(payload_size > 0 and payload_size <= 32, "an acknowledgement payload is 1-32 bytes");
+    public:
+        /**
+         * @brief
+         * Struct reply that contains a queued acknowledgement payload
+         */
+        struct reply {
+            /**
+             * @brief
+             * amount of bytes in the reply
+             */
+            uint8_t length;
+            /**
+             * @brief
+             * the reply, data[0] is the first byte of the payload
+             */
+            std::array<uint8_t, payload_size> data;
+        };
+
+    private:
+        /**
+         * @brief
+         * RF24L01 object the replies are loaded in
+         */
+        RF24L01 &chip;
+        /**
+         * @brief
+         * Ring_Buffer with the replies that are not loaded yet, one per pipe
+         */
+        std::array<Ring_Buffer<reply, depth>, 6> queues;
+        /**
+         * @brief
+         * amount of replies per pipe that are loaded in the RF24L01
+         */
+        std::array<uint8_t, 6> loaded = {};
+        /**
+         * @brief
+         * amount of replies that are loaded in the RF24L01, at most the 3 payloads of the TX FIFO
+         */
+        uint8_t loaded_total = 0;
+
+        /**
+         * @brief
+         * function to load the next reply of a pipe if the pipe has none loaded and the TX FIFO has room
+         * @param pipe the pipe 0-5
+         */
+        void load(uint8_t pipe) {
+            const reply *next = queues[pipe].front();
+            if (next == nullptr or loaded[pipe] > 0 or loaded_total >= 3) {
+                return;
+            }
+            if (chip.write_ack_payload(pipe, next->data.begin(), next->length)) {
+                queues[pipe].pop_front();
+                loaded[pipe]++;
+                loaded_total++;
+            }
+        }
+
+    public:
+        /**
+         * @brief
+         * constructor for the RF24L01_Ack_Channel
+         * @param chip RF24L01 object in RX-mode with acknowledgement payloads enabled, its TX FIFO must be empty
+         */
+        explicit RF24L01_Ack_Channel(RF24L01 &chip) :
+                chip(chip) {}
+
+        /**
+         * @brief
+         * function to queue a reply on a pipe
+         * @details
+         * The reply is loaded in the RF24L01 directly when the pipe has no reply loaded
+         * @param pipe the pipe 0-5
+         * @param data buffer that contains the reply
+         * @param length amount of bytes in the reply, 1-payload_size
+         * @return returns false if the pipe or the length is not valid or the queue of the pipe is full
+         */
+        bool queue(uint8_t pipe, const uint8_t data[], size_t length) {
+            if (pipe > 5 or length == 0 or length > payload_size) {
+                return false;
+            }
+            reply *slot = queues[pipe].producer_slot();
+            if (slot == nullptr) {
+                return false;
+            }
+            slot->length = length;
+            for (size_t i = 0; i < length; i++) {
+                slot->data[i] = data[i];
+            }
+            queues[pipe].commit();
+            load(pipe);
+            return true;
+        }
+
+        /**
+         * @brief
+         * function to call for every payload that's received on a pipe
+         * @details
+         * When the pipe has a reply loaded, one SPI-transaction reads REGISTER::FIFO_STATUS to see if the RF24L01 has
+         * send it with the acknowledgement of the payload. Then the next reply of the pipe is loaded, and the replies
+         * of other pipes that waited for room in the TX FIFO.
+         * @param pipe the pipe 0-5 of the received payload
+         */
+        void payload_received(uint8_t pipe) {
+            if (pipe > 5) {
+                return;
+            }
+            if (loaded[pipe] > 0) {
+                const uint8_t fifo_status = chip.register_read(RF24L01::REGISTER::FIFO_STATUS);
+                if (fifo_status & RF24L01::SETTING::TX_EMPTY.Mask) {
+                    //every loaded reply went out
+                    loaded = {};
+                    loaded_total = 0;
+                } else if (not(fifo_status & RF24L01::SETTING::TX_FULL.Mask) and loaded_total > 1) {
+                    //at least 1 of the loaded replies is left, the one of this pipe went out with its acknowledgement
+                    loaded[pipe]--;
+                    loaded_total--;
+                }
+            }
+            load(pipe);
+            refill();
+        }
+
+        /**
+         * @brief
+         * function to load the queued replies of all pipes that have room
+         */
+        void refill() {
+            for (uint8_t pipe = 0; pipe < 6; pipe++) {
+                load(pipe);
+            }
+        }
+
+        /**
+         * @brief
+         * function to get the amount of replies of a pipe that are not send yet
+         * @param pipe the pipe 0-5
+         * @return size_t amount of queued and loaded replies
+         */
+        size_t pending(uint8_t pipe) const {
+            return pipe > 5 ? 0 : queues[pipe].size() + loaded[pipe];
+        }
+
+        /**
+         * @brief
+         * function to remove all replies, the TX FIFO of the RF24L01 is flushed
+         */
+        void clear() {
+            chip.write_command(RF24L01::COMMAND::FLUSH_TX);
+            reply discarded = {};
+            for (uint8_t pipe = 0; pipe < 6; pipe++) {
+                while (queues[pipe].pop(discarded)) {}
+                loaded[pipe] = 0;
+            }
+            loaded_total = 0;
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_ACK_CHANNEL_H
@@ -0,0 +1,270 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Async_TX.hpp
+ *  @brief     IPASS-project: Non-blocking transmitter for the RF24L01 with a callback per payload.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_ASYNC_TX_H
+#define IPASS_RF24L01_ASYNC_TX_H
+
+#include "RF24L01.hpp"
+#include "../Ring_Buffer/Ring_Buffer.hpp"
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Non-blocking transmitter that reports the outcome of every payload with a callback
+     * @details
+     * submit() queues a payload in a Ring_Buffer and returns a handle directly, the main loop keeps running while the
+     * payload is in flight. The transmitter keeps one payload in the TX FIFO of the RF24L01, so every TX_DS or MAX_RT
+     * belongs to that payload; stream_tx() of the RF24L01 sends back-to-back when throughput matters more. poll()
+     * checks the IRQ-pin, which costs no SPI-transaction, and on_irq() can be called from a falling edge interrupt
+     * handler instead. A payload costs 2 SPI-transactions: writing it, and the write of REGISTER::STATUS that clears
+     * TX_DS or MAX_RT and returns the flags. CE is only high while there are payloads, starting after an empty queue
+     * costs the 5 SPI-transactions of RF24L01::start_TX_stream() once. Call submit() and
+     * poll() or on_irq() from the same context, the callback runs in that context too and may submit() again.
+     * @tparam payload_size the maximum amount of bytes in a payload, 1-32
+     * @tparam depth the amount of payloads the queue can store, must be a power of 2
+     */
+    template<size_t payload_size, size_t depth>
+    class RF24L01_Async_TX {
+        static_assert(payload_size > 0 and payload_size <= 32, "a payload is 1-32 bytes");
+    public:
+        /**
+         * @brief
+         * Outcome of a payload, passed to its callback
+         */
+        enum class outcome {
+            ///the payload is acknowledged, TX_DS
+            delivered,
+            ///the payload is not acknowledged after the retransmits of SETUP_RETR, MAX_RT
+            max_rt,
+            ///neither TX_DS nor MAX_RT within the timeout
+            timeout
+        };
+
+        /**
+         * @brief
+         * Callback of a payload: callback(context, handle, result)
+         */
+        using callback = void (*)(void *context, uint16_t handle, outcome result);
+
+    private:
+        /**
+         * @brief
+         * Struct request that contains a submitted payload
+         */
+        struct request {
+            ///handle returned by submit()
+            uint16_t handle;
+            ///amount of bytes in the payload
+            uint8_t length;
+            ///the payload, data[0] is send first
+            std::array<uint8_t, payload_size> data;
+            ///function called with the outcome, may be nullptr
+            callback done;
+            ///first parameter of done
+            void *context;
+        };
+
+        /**
+         * @brief
+         * RF24L01 object in TX-mode the payloads are send with
+         */
+        RF24L01 &chip;
+        /**
+         * @brief
+         * Ring_Buffer with the payloads that are not written to the RF24L01 yet
+         */
+        Ring_Buffer<request, depth> queue;
+        /**
+         * @brief
+         * the payload in the TX FIFO, only valid if busy is true
+         */
+        request in_flight = {};
+        /**
+         * @brief
+         * boolean that's true while a payload is in the TX FIFO
+         */
+        bool busy = false;
+        /**
+         * @brief
+         * boolean that's true while CE is high
+         */
+        bool transmitting = false;
+        /**
+         * @brief
+         * time in us after which the payload in flight times out
+         */
+        uint_fast64_t deadline = 0;
+        /**
+         * @brief
+         * maximum time in us between writing a payload and its TX_DS or MAX_RT
+         */
+        uint_fast64_t timeout_us;
+        /**
+         * @brief
+         * handle of the last submitted payload
+         */
+        uint16_t last_handle = 0;
+        /**
+         * @brief
+         * amount of delivered payloads
+         */
+        uint32_t delivered_count = 0;
+        /**
+         * @brief
+         * amount of payloads that failed with MAX_RT or a timeout
+         */
+        uint32_t failed_count = 0;
+
+        /**
+         * @brief
+         * function to report the outcome of the payload in flight
+         * @param result the outcome
+         */
+        void finish(outcome result) {
+            busy = false;
+            if (result == outcome::delivered) {
+                delivered_count++;
+            } else {
+                failed_count++;
+            }
+            if (in_flight.done != nullptr) {
+                in_flight.done(in_flight.context, in_flight.handle, result);
+            }
+        }
+
+        /**
+         * @brief
+         * function to write the next queued payload when none is in flight, CE goes low when the queue is empty
+         */
+        void load() {
+            if (busy) {
+                return;
+            }
+            if (not queue.pop(in_flight)) {
+                if (transmitting) {
+                    chip.stop_TX_stream();
+                    transmitting = false;
+                }
+                return;
+            }
+            chip.load_tx(in_flight.data.begin(), in_flight.length);
+            if (not transmitting) {
+                chip.start_TX_stream();
+                transmitting = true;
+            }
+            deadline = hwlib::now_us() + timeout_us;
+            busy = true;
+        }
+
+    public:
+        /**
+         * @brief
+         * constructor for the RF24L01_Async_TX
+         * @param chip RF24L01 object in TX-mode with an empty TX FIFO
+         * @param timeout_us maximum time in us between writing a payload and its TX_DS or MAX_RT, default value = 100 ms
+         */
+        explicit RF24L01_Async_TX(RF24L01 &chip, uint_fast64_t timeout_us = 100'000) :
+                chip(chip), timeout_us(timeout_us) {}
+
+        /**
+         * @brief
+         * function to queue a payload
+         * @details
+         * The payload is written to the RF24L01 directly when none is in flight
+         * @param data buffer that contains the payload, data[0] is send first
+         * @param length amount of bytes in the payload, 1-payload_size
+         * @param done function called with the outcome of the payload, default value = nullptr
+         * @param context first parameter of done, default value = nullptr
+         * @return uint16_t handle of the payload, 0 if the length is not valid or the queue is full
+         */
+        uint16_t submit(const uint8_t data[], size_t length, callback done = nullptr, void *context = nullptr) {
+            if (length == 0 or length > payload_size) {
+                return 0;
+            }
+            request *slot = queue.producer_slot();
+            if (slot == nullptr) {
+                return 0;
+            }
+            last_handle = last_handle == 0xFFFF ? 1 : last_handle + 1;
+            slot->handle = last_handle;
+            slot->length = length;
+            for (size_t i = 0; i < length; i++) {
+                slot->data[i] = data[i];
+            }
+            slot->done = done;
+            slot->context = context;
+            queue.commit();
+            load();
+            return last_handle;
+        }
+
+        /**
+         * @brief
+         * function to handle TX_DS and MAX_RT, can be called from a falling edge interrupt handler of the IRQ-pin
+         * @details
+         * The write that clears TX_DS and MAX_RT returns the STATUS byte with the flags. After MAX_RT the payload is
+         * flushed. Then the next queued payload is written.
+         */
+        void on_irq() {
+            chip.register_write(RF24L01::REGISTER::STATUS, RF24L01::SETTING::TX_DS.Mask | RF24L01::SETTING::MAX_RT.Mask);
+            if (busy and chip.last_status(RF24L01::SETTING::TX_DS)) {
+                finish(outcome::delivered);
+            } else if (busy and chip.last_status(RF24L01::SETTING::MAX_RT)) {
+                chip.write_command(RF24L01::COMMAND::FLUSH_TX);
+                finish(outcome::max_rt);
+            }
+            load();
+        }
+
+        /**
+         * @brief
+         * function to call from the main loop when the IRQ-pin has no interrupt handler
+         * @details
+         * Calls on_irq() when the IRQ-pin is low, and fails the payload in flight after the timeout. Without a
+         * pending interrupt or timeout it costs no SPI-transaction.
+         */
+        void poll() {
+            if (chip.interrupt_pending()) {
+                on_irq();
+            } else if (busy and hwlib::now_us() > deadline) {
+                chip.stop_TX_stream();
+                transmitting = false;
+                chip.write_command(RF24L01::COMMAND::FLUSH_TX);
+                finish(outcome::timeout);
+                load();
+            }
+        }
+
+        /**
+         * @brief
+         * function to get the amount of payloads that are queued or in flight
+         * @return size_t amount of payloads without an outcome
+         */
+        size_t pending() const {
+            return queue.size() + (busy ? 1 : 0);
+        }
+
+        /**
+         * @brief
+         * function to get the amount of delivered payloads
+         * @return uint32_t amount of payloads with outcome::delivered
+         */
+        uint32_t delivered() const {
+            return delivered_count;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of failed payloads
+         * @return uint32_t amount of payloads with outcome::max_rt or outcome::timeout
+         */
+        uint32_t failed() const {
+            return failed_count;
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_ASYNC_TX_H
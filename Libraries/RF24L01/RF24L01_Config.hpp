@@ -0,0 +1,341 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Config.hpp
+ *  @brief     IPASS-project: Compile-time register image of the RF24L01 configuration.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_CONFIG_H
+#define IPASS_RF24L01_CONFIG_H
+
+#include "RF24L01.hpp"
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Complete register image of the configuration of the RF24L01
+     * @details
+     * Every function returns a copy with one part of the configuration changed, so the image is build at compile time:
+     * @code
+     * constexpr IPASS::RF24L01_Config config = IPASS::RF24L01_Config()
+     *         .channel(0x11)
+     *         .data_rate_2mbps(false)
+     *         .rx_address(0, address)
+     *         .tx_address(address)
+     *         .pipe(0, true, 5);
+     * chip.apply<config>();
+     * @endcode
+     * RF24L01::apply() writes every register once and reads nothing. The default image is the reset image of the
+     * RF24L01 with a 2 byte CRC and PWR_UP in CONFIG: channel 2, 2 Mbps, auto acknowledgement on every pipe, pipe 0 and 1
+     * enabled with a payload width of 0, 3 retransmits and powered up in TX-mode.
+     */
+    class RF24L01_Config {
+    public:
+        ///value of REGISTER::CONFIG
+        uint8_t config = 0x0E;
+        ///value of REGISTER::EN_AA
+        uint8_t en_aa = 0x3F;
+        ///value of REGISTER::EN_RXADDR
+        uint8_t en_rxaddr = 0x03;
+        ///value of REGISTER::SETUP_AW
+        uint8_t setup_aw = 0x03;
+        ///value of REGISTER::SETUP_RETR
+        uint8_t setup_retr = 0x03;
+        ///value of REGISTER::RF_CH
+        uint8_t rf_ch = 0x02;
+        ///value of REGISTER::RF_SETUP
+        uint8_t rf_setup = 0x0F;
+        ///values of REGISTER::RX_PW_P0 up to REGISTER::RX_PW_P5
+        std::array<uint8_t, 6> rx_pw = {};
+        ///value of REGISTER::DYNPD
+        uint8_t dynpd = 0x00;
+        ///value of REGISTER::FEATURE
+        uint8_t feature = 0x00;
+        ///address of pipe 0, in the byte order of RF24L01::change_ADDR()
+        std::array<uint8_t, 5> rx_addr_p0 = {0xE7, 0xE7, 0xE7, 0xE7, 0xE7};
+        ///address of pipe 1, in the byte order of RF24L01::change_ADDR()
+        std::array<uint8_t, 5> rx_addr_p1 = {0xC2, 0xC2, 0xC2, 0xC2, 0xC2};
+        ///least significant address byte of pipe 2 up to 5
+        std::array<uint8_t, 4> rx_addr_p2_p5 = {0xC3, 0xC4, 0xC5, 0xC6};
+        ///the TX address, in the byte order of RF24L01::change_ADDR()
+        std::array<uint8_t, 5> tx_addr = {0xE7, 0xE7, 0xE7, 0xE7, 0xE7};
+        ///false if retries() got a delay or amount above 15
+        bool retries_in_range = true;
+        ///false if pipe() or rx_address() got a pipe above 5
+        bool pipes_in_range = true;
+
+        /**
+         * @brief
+         * function to set the size of the addresses
+         * @param bytes the size of the addresses, 3, 4 or 5 bytes
+         * @return RF24L01_Config copy with the new address width
+         */
+        constexpr RF24L01_Config address_width(uint8_t bytes) const {
+            RF24L01_Config result = *this;
+            result.setup_aw = bytes - 2;
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to set the RF-channel
+         * @param value the channel 0-127, the frequency is 2400+value [MHz]
+         * @return RF24L01_Config copy with the new channel
+         */
+        constexpr RF24L01_Config channel(uint8_t value) const {
+            RF24L01_Config result = *this;
+            result.rf_ch = value;
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to set the CRC
+         * @details
+         * The RF24L01 forces the CRC on when auto acknowledgement is enabled on a pipe, valid() rejects that combination
+         * @param enable boolean that's true to enable the CRC
+         * @param two_bytes boolean that's true for a 2 byte CRC, false for 1 byte
+         * @return RF24L01_Config copy with the new CRC
+         */
+        constexpr RF24L01_Config crc(bool enable, bool two_bytes = true) const {
+            RF24L01_Config result = *this;
+            result.config &= ~(RF24L01::SETTING::EN_CRC.Mask | RF24L01::SETTING::CRCO.Mask);
+            if (enable) {
+                result.config |= RF24L01::SETTING::EN_CRC.Mask;
+                if (two_bytes) {
+                    result.config |= RF24L01::SETTING::CRCO.Mask;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to set the data rate
+         * @param two_mbps boolean that's true for 2 Mbps, false for 1 Mbps
+         * @return RF24L01_Config copy with the new data rate
+         */
+        constexpr RF24L01_Config data_rate_2mbps(bool two_mbps) const {
+            RF24L01_Config result = *this;
+            if (two_mbps) {
+                result.rf_setup |= RF24L01::SETTING::RF_DR.Mask;
+            } else {
+                result.rf_setup &= ~RF24L01::SETTING::RF_DR.Mask;
+            }
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to enable dynamic payload length
+         * @details
+         * Also enables auto acknowledgement on the pipes, which dynamic payload length needs
+         * @param pipes bitmask of the pipes with dynamic payload length, 0 disables dynamic payload length
+         * @return RF24L01_Config copy with dynamic payload length
+         */
+        constexpr RF24L01_Config dynamic_payloads(uint8_t pipes) const {
+            RF24L01_Config result = *this;
+            result.dynpd = pipes;
+            result.en_aa |= pipes;
+            if (pipes != 0) {
+                result.feature |= RF24L01::SETTING::EN_DPL.Mask;
+            } else {
+                result.feature &= ~RF24L01::SETTING::EN_DPL.Mask;
+            }
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to enable or disable the feature bits for acknowledgement payloads and payloads without ack
+         * @param ack_payloads boolean that's true to enable SETTING::EN_ACK_PAY
+         * @param dynamic_ack boolean that's true to enable SETTING::EN_DYN_ACK
+         * @return RF24L01_Config copy with the new features
+         */
+        constexpr RF24L01_Config features(bool ack_payloads, bool dynamic_ack) const {
+            RF24L01_Config result = *this;
+            result.feature &= RF24L01::SETTING::EN_DPL.Mask;
+            if (ack_payloads) {
+                result.feature |= RF24L01::SETTING::EN_ACK_PAY.Mask;
+            }
+            if (dynamic_ack) {
+                result.feature |= RF24L01::SETTING::EN_DYN_ACK.Mask;
+            }
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to configure a RX-pipe
+         * @param number the pipe 0-5
+         * @param enabled boolean that's true to enable the pipe
+         * @param width the payload width 1-32, 0 for a pipe with dynamic payload length
+         * @param auto_ack boolean that's true to enable auto acknowledgement on the pipe
+         * @return RF24L01_Config copy with the new pipe configuration, unchanged for a pipe above 5
+         */
+        constexpr RF24L01_Config pipe(uint8_t number, bool enabled, uint8_t width, bool auto_ack = true) const {
+            RF24L01_Config result = *this;
+            if (number >= 6) {
+                result.pipes_in_range = false;
+                return result;
+            }
+            uint8_t mask = 1 << number;
+            result.en_rxaddr = enabled ? (en_rxaddr | mask) : (en_rxaddr & ~mask);
+            result.en_aa = auto_ack ? (en_aa | mask) : (en_aa & ~mask);
+            result.rx_pw[number] = width;
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to set the output power
+         * @param level the power 0-3: -18 dBm, -12 dBm, -6 dBm or 0 dBm
+         * @return RF24L01_Config copy with the new power
+         */
+        constexpr RF24L01_Config power(uint8_t level) const {
+            RF24L01_Config result = *this;
+            result.rf_setup = (rf_setup & ~0x06) | ((level & 0x03) << 1);
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to set the auto retransmit settings
+         * @param ard the auto retransmit delay 0-15, a delay of (ard + 1) * 250 us
+         * @param arc the maximum amount of retransmits 0-15
+         * @return RF24L01_Config copy with the new retransmit settings
+         */
+        constexpr RF24L01_Config retries(uint8_t ard, uint8_t arc) const {
+            RF24L01_Config result = *this;
+            result.setup_retr = ((ard & 0x0F) << 4) | (arc & 0x0F);
+            result.retries_in_range = ard <= 0x0F and arc <= 0x0F;
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to set the address of a RX-pipe
+         * @details
+         * Pipe 2 up to 5 only have their own least significant byte, address[4], the other bytes are those of pipe 1
+         * @param number the pipe 0-5
+         * @param address the address, in the byte order of RF24L01::change_ADDR()
+         * @return RF24L01_Config copy with the new address, unchanged for a pipe above 5
+         */
+        constexpr RF24L01_Config rx_address(uint8_t number, const std::array<uint8_t, 5> &address) const {
+            RF24L01_Config result = *this;
+            if (number == 0) {
+                result.rx_addr_p0 = address;
+            } else if (number == 1) {
+                result.rx_addr_p1 = address;
+            } else if (number < 6) {
+                result.rx_addr_p2_p5[number - 2] = address[4];
+            } else {
+                result.pipes_in_range = false;
+            }
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to start in RX- or TX-mode
+         * @param rx boolean that's true for RX-mode
+         * @return RF24L01_Config copy with the new mode
+         */
+        constexpr RF24L01_Config rx_mode(bool rx) const {
+            RF24L01_Config result = *this;
+            if (rx) {
+                result.config |= RF24L01::SETTING::PRIM_RX.Mask;
+            } else {
+                result.config &= ~RF24L01::SETTING::PRIM_RX.Mask;
+            }
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to set the TX address
+         * @param address the address, in the byte order of RF24L01::change_ADDR()
+         * @return RF24L01_Config copy with the new TX address
+         */
+        constexpr RF24L01_Config tx_address(const std::array<uint8_t, 5> &address) const {
+            RF24L01_Config result = *this;
+            result.tx_addr = address;
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to check the address width and the channel
+         * @return boolean that's true if the address width is 3-5 bytes and the channel is 0-127
+         */
+        constexpr bool valid_address_and_channel() const {
+            return setup_aw >= 0x01 and setup_aw <= 0x03 and rf_ch < 0x80;
+        }
+
+        /**
+         * @brief
+         * function to check the CRC against auto acknowledgement
+         * @return boolean that's true if the CRC is enabled or no pipe uses auto acknowledgement
+         */
+        constexpr bool valid_crc() const {
+            return (config & RF24L01::SETTING::EN_CRC.Mask) or (en_aa & 0x3F) == 0;
+        }
+
+        /**
+         * @brief
+         * function to check the payload widths of the pipes
+         * @details
+         * A width of 0 is allowed, pipe 0 of a transmitter is enabled to receive the acknowledgements and needs no width
+         * @return boolean that's true if every pipe has a width of 0-32
+         */
+        constexpr bool valid_payload_widths() const {
+            for (uint8_t width : rx_pw) {
+                if (width > 32) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief
+         * function to check the features
+         * @return boolean that's true if the pipes with dynamic payload length use auto acknowledgement and if
+         * acknowledgement payloads have dynamic payload length
+         */
+        constexpr bool valid_features() const {
+            bool dpl = feature & RF24L01::SETTING::EN_DPL.Mask;
+            bool ack_pay = feature & RF24L01::SETTING::EN_ACK_PAY.Mask;
+            return (dynpd & ~en_aa & 0x3F) == 0 and (dynpd == 0 or dpl) and (not ack_pay or dpl);
+        }
+
+        /**
+         * @brief
+         * function to check the pipe numbers
+         * @return boolean that's true if pipe() and rx_address() only got pipes 0-5
+         */
+        constexpr bool valid_pipe_numbers() const {
+            return pipes_in_range;
+        }
+
+        /**
+         * @brief
+         * function to check the retransmit settings
+         * @return boolean that's true if the delay and the amount of retransmits are 0-15
+         */
+        constexpr bool valid_retries() const {
+            return retries_in_range;
+        }
+
+        /**
+         * @brief
+         * function to check the complete configuration
+         * @return boolean that's true if all checks pass
+         */
+        constexpr bool valid() const {
+            return valid_address_and_channel() and valid_crc() and valid_payload_widths() and valid_features() and
+                   valid_pipe_numbers() and valid_retries();
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_CONFIG_H
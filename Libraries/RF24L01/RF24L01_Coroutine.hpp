@@ -0,0 +1,235 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Coroutine.hpp
+ *  @brief     IPASS-project: co_await front-end of the RF24L01 for a Coroutine_Scheduler.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_COROUTINE_H
+#define IPASS_RF24L01_COROUTINE_H
+
+#include "RF24L01.hpp"
+#include "RF24L01_Async_TX.hpp"
+#include "../Coroutine/Coroutine.hpp"
+#include "../Ring_Buffer/Ring_Buffer.hpp"
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Radio for coroutines: co_await send() and co_await receive()
+     * @details
+     * Sends with a RF24L01_Async_TX and receives with RF24L01::drain_rx(), both driven by a poller of the scheduler
+     * that only costs SPI-transactions when the IRQ-pin is low. A coroutine that awaits is suspended until its
+     * payload is acknowledged or failed, or until a payload is received, so the other coroutines keep running:
+     * @code
+     * IPASS::Coroutine_Task<> sender(IPASS::RF24L01_Coroutine<5, 4, 8> &radio, IPASS::Coroutine_Scheduler<8> &loop) {
+     *     const uint8_t data[5] = {0x11, 0x22, 0x33, 0x44, 0x00};
+     *     for (;;) {
+     *         co_await radio.send(data, 5);
+     *         co_await loop.sleep_us(100'000);
+     *     }
+     * }
+     * @endcode
+     * @tparam payload_size the payload width of the pipes, 1-32
+     * @tparam depth the amount of payloads the TX queue and the RX buffer can store, must be a power of 2
+     * @tparam capacity the capacity of the Coroutine_Scheduler
+     * @tparam pollers the amount of pollers of the Coroutine_Scheduler
+     */
+    template<size_t payload_size, size_t depth, size_t capacity, size_t pollers = 4>
+    class RF24L01_Coroutine {
+    public:
+        /**
+         * @brief
+         * the transmitter
+         */
+        using async_tx = RF24L01_Async_TX<payload_size, depth>;
+        /**
+         * @brief
+         * the scheduler
+         */
+        using scheduler_type = Coroutine_Scheduler<capacity, pollers>;
+
+    private:
+        /**
+         * @brief
+         * RF24L01 object the payloads are send and received with
+         */
+        RF24L01 &chip;
+        /**
+         * @brief
+         * the scheduler of the coroutines that await
+         */
+        scheduler_type &scheduler;
+        /**
+         * @brief
+         * transmitter of send()
+         */
+        async_tx transmitter;
+        /**
+         * @brief
+         * Ring_Buffer with the received payloads
+         */
+        Ring_Buffer<RF24L01::received_payload, depth> received;
+        /**
+         * @brief
+         * coroutine that waits in receive(), nullptr if there is none
+         */
+        std::coroutine_handle<> receiver = nullptr;
+        /**
+         * @brief
+         * amount of payloads that are dropped because the RX buffer was full
+         */
+        uint32_t overflows = 0;
+
+        /**
+         * @brief
+         * poller of the scheduler, handles the IRQ-pin
+         * @param context the RF24L01_Coroutine
+         */
+        static void poll(void *context) {
+            RF24L01_Coroutine &radio = *static_cast<RF24L01_Coroutine *>(context);
+            if (radio.transmitter.pending() > 0) {
+                radio.transmitter.poll();
+            } else if (radio.chip.interrupt_pending()) {
+                radio.chip.drain_rx([&radio](uint8_t pipe, const uint8_t data[], size_t length) {
+                    RF24L01::received_payload *slot = radio.received.producer_slot();
+                    if (slot == nullptr) {
+                        radio.overflows++;
+                        return;
+                    }
+                    slot->pipe = pipe;
+                    slot->length = length;
+                    for (size_t i = 0; i < length; i++) {
+                        slot->data[i] = data[i];
+                    }
+                    radio.received.commit();
+                }, payload_size);
+            }
+            if (radio.receiver and radio.received.size() > 0) {
+                radio.scheduler.wake(radio.receiver);
+                radio.receiver = nullptr;
+            }
+        }
+
+        /**
+         * @brief
+         * callback of the transmitter, wakes the coroutine of the payload
+         * @param context the send_awaiter
+         * @param result the outcome of the payload
+         */
+        static void sent(void *context, uint16_t, typename async_tx::outcome result);
+
+    public:
+        /**
+         * @brief
+         * Awaiter of send(), co_await returns the outcome of the payload
+         */
+        struct send_awaiter {
+            ///the radio
+            RF24L01_Coroutine &radio;
+            ///the payload
+            const uint8_t *data;
+            ///amount of bytes in the payload
+            size_t length;
+            ///the coroutine that awaits
+            std::coroutine_handle<> handle = nullptr;
+            ///the outcome of the payload
+            typename async_tx::outcome result = async_tx::outcome::timeout;
+
+            ///a send always suspends until its outcome is known
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            ///queues the payload, doesn't suspend when the queue is full, which returns outcome::timeout
+            bool await_suspend(std::coroutine_handle<>) noexcept {
+                handle = radio.scheduler.wait();
+                if (radio.transmitter.submit(data, length, sent, this) == 0) {
+                    radio.scheduler.wake(handle);
+                    return false;
+                }
+                return true;
+            }
+
+            ///returns the outcome
+            typename async_tx::outcome await_resume() const noexcept {
+                return result;
+            }
+        };
+
+        /**
+         * @brief
+         * Awaiter of receive(), co_await returns the oldest received payload
+         */
+        struct receive_awaiter {
+            ///the radio
+            RF24L01_Coroutine &radio;
+
+            ///doesn't suspend when a payload is received already
+            bool await_ready() const noexcept {
+                return radio.received.size() > 0;
+            }
+
+            ///waits for the poller, one coroutine can wait at a time
+            void await_suspend(std::coroutine_handle<>) noexcept {
+                radio.receiver = radio.scheduler.wait();
+            }
+
+            ///returns the oldest received payload
+            RF24L01::received_payload await_resume() noexcept {
+                RF24L01::received_payload payload = {};
+                radio.received.pop(payload);
+                return payload;
+            }
+        };
+
+        /**
+         * @brief
+         * constructor for the RF24L01_Coroutine, adds the poller to the scheduler
+         * @param chip RF24L01 object in TX-mode for send() or in RX-mode for receive()
+         * @param scheduler the scheduler of the coroutines that use the radio
+         */
+        RF24L01_Coroutine(RF24L01 &chip, scheduler_type &scheduler) :
+                chip(chip), scheduler(scheduler), transmitter(chip) {
+            scheduler.add_poller(poll, this);
+        }
+
+        /**
+         * @brief
+         * function to send a payload
+         * @param data buffer that contains the payload, data[0] is send first, must stay valid during the co_await
+         * @param length amount of bytes in the payload, 1-payload_size
+         * @return send_awaiter for co_await, which returns the outcome of the payload
+         */
+        send_awaiter send(const uint8_t data[], size_t length) {
+            return {*this, data, length};
+        }
+
+        /**
+         * @brief
+         * function to wait for a payload
+         * @return receive_awaiter for co_await, which returns RF24L01::received_payload
+         */
+        receive_awaiter receive() {
+            return {*this};
+        }
+
+        /**
+         * @brief
+         * function to get the amount of payloads dropped because the RX buffer was full
+         * @return uint32_t amount of dropped payloads
+         */
+        uint32_t overflow_count() const {
+            return overflows;
+        }
+    };
+
+    template<size_t payload_size, size_t depth, size_t capacity, size_t pollers>
+    void RF24L01_Coroutine<payload_size, depth, capacity, pollers>::sent(void *context, uint16_t,
+                                                                         typename async_tx::outcome result) {
+        send_awaiter &awaiter = *static_cast<send_awaiter *>(context);
+        awaiter.result = result;
+        awaiter.radio.scheduler.wake(awaiter.handle);
+    }
+} //namespace IPASS
+#endif //IPASS_RF24L01_COROUTINE_H
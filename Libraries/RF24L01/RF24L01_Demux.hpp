@@ -0,0 +1,193 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Demux.hpp
+ *  @brief     IPASS-project: Demultiplexer that routes received payloads to a handler per RX-pipe.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_DEMUX_H
+#define IPASS_RF24L01_DEMUX_H
+
+#include "RF24L01.hpp"
+#include "../Ring_Buffer/Ring_Buffer.hpp"
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Interface for a receiver of the payloads of one or more RX-pipes
+     */
+    class RF24L01_Pipe_Handler {
+    public:
+        /**
+         * @brief
+         * virtual destructor, a handler can be deleted through this interface
+         */
+        virtual ~RF24L01_Pipe_Handler() = default;
+
+        /**
+         * @brief
+         * function that's called for every received payload on a pipe the handler is bound to
+         * @param pipe the pipe 0-5 on which the payload was received
+         * @param data buffer with the payload, only valid during the call
+         * @param length amount of bytes in the payload
+         */
+        virtual void received(uint8_t pipe, const uint8_t data[], size_t length) = 0;
+    };
+
+    /**
+     * @brief
+     * RF24L01_Pipe_Handler that stores the payloads in a Ring_Buffer
+     * @tparam capacity the amount of payloads the queue can store, must be a power of 2
+     */
+    template<size_t capacity>
+    class RF24L01_Pipe_Queue : public RF24L01_Pipe_Handler {
+    public:
+        /**
+         * @brief
+         * Struct payload that contains a received payload
+         */
+        struct payload {
+            ///the pipe 0-5 on which the payload was received
+            uint8_t pipe;
+            ///the amount of bytes in data
+            uint8_t length;
+            ///the payload, data[0] is the first byte of the payload
+            std::array<uint8_t, 32> data;
+        };
+
+    private:
+        /**
+         * @brief
+         * Ring_Buffer that contains the received payloads
+         */
+        Ring_Buffer<payload, capacity> payloads;
+        /**
+         * @brief
+         * amount of payloads that are dropped because the queue was full
+         */
+        uint32_t overflows = 0;
+
+    public:
+        void received(uint8_t pipe, const uint8_t data[], size_t length) override {
+            payload *slot = payloads.producer_slot();
+            if (slot == nullptr) {
+                overflows++;
+                return;
+            }
+            slot->pipe = pipe;
+            slot->length = length;
+            for (size_t i = 0; i < length; i++) {
+                slot->data[i] = data[i];
+            }
+            payloads.commit();
+        }
+
+        /**
+         * @brief
+         * function to get the oldest payload of the queue
+         * @param payload_out the oldest payload is stored in this parameter
+         * @return returns false if the queue is empty
+         */
+        bool pop(payload &payload_out) {
+            return payloads.pop(payload_out);
+        }
+
+        /**
+         * @brief
+         * function to get the amount of payloads dropped because the queue was full
+         * @return uint32_t amount of dropped payloads
+         */
+        uint32_t overflow_count() const {
+            return overflows;
+        }
+    };
+
+    /**
+     * @brief
+     * Demultiplexer for the 6 RX-pipes of the RF24L01
+     * @details
+     * Reads the payloads from the RX FIFO with RF24L01::drain_rx(), which decodes the pipe from the RX_P_NO-value of
+     * the STATUS byte, and calls the RF24L01_Pipe_Handler bound to that pipe. Configure the pipes first with
+     * RF24L01::configure_pipes(), the RF24L01 remembers the width of every pipe so the pipes can have different widths.
+     */
+    class RF24L01_Demux {
+    private:
+        /**
+         * @brief
+         * RF24L01 object the payloads are read from
+         */
+        RF24L01 &chip;
+        /**
+         * @brief
+         * the handler of every pipe, nullptr if no handler is bound
+         */
+        std::array<RF24L01_Pipe_Handler *, 6> handlers = {};
+        /**
+         * @brief
+         * amount of payloads received on a pipe without a handler
+         */
+        uint32_t unhandled = 0;
+
+    public:
+        /**
+         * @brief
+         * constructor for the RF24L01_Demux
+         * @param chip RF24L01 object that's in RX-mode, see RF24L01::start_RX()
+         */
+        explicit RF24L01_Demux(RF24L01 &chip) :
+                chip(chip) {}
+
+        /**
+         * @brief
+         * function to bind a handler to a pipe
+         * @details
+         * One handler can be bound to multiple pipes, the pipe is passed to RF24L01_Pipe_Handler::received()
+         * @param pipe the pipe 0-5
+         * @param handler the handler that receives the payloads of the pipe
+         */
+        void bind(uint8_t pipe, RF24L01_Pipe_Handler &handler) {
+            if (pipe < 6) {
+                handlers[pipe] = &handler;
+            }
+        }
+
+        /**
+         * @brief
+         * function to remove the handler of a pipe, payloads on that pipe are counted as unhandled
+         * @param pipe the pipe 0-5
+         */
+        void unbind(uint8_t pipe) {
+            if (pipe < 6) {
+                handlers[pipe] = nullptr;
+            }
+        }
+
+        /**
+         * @brief
+         * function to read all payloads from the RX FIFO and pass them to the handlers
+         * @details
+         * N payloads cost N + 2 SPI-transactions, 2N + 2 with dynamic payload length. RX_DR is cleared when the FIFO
+         * is empty.
+         * @return size_t amount of payloads that are read
+         */
+        size_t poll() {
+            return chip.drain_rx([this](uint8_t pipe, const uint8_t data[], size_t length) {
+                if (handlers[pipe] != nullptr) {
+                    handlers[pipe]->received(pipe, data, length);
+                } else {
+                    unhandled++;
+                }
+            });
+        }
+
+        /**
+         * @brief
+         * function to get the amount of payloads received on a pipe without a handler
+         * @return uint32_t amount of unhandled payloads
+         */
+        uint32_t unhandled_count() const {
+            return unhandled;
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_DEMUX_H
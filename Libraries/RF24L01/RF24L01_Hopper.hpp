@@ -0,0 +1,235 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Hopper.hpp
+ *  @brief     IPASS-project: Frequency hopping of a transmitter and a receiver over a seeded hop sequence.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_HOPPER_H
+#define IPASS_RF24L01_HOPPER_H
+
+#include "RF24L01.hpp"
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Frequency hopping over a pseudo-random sequence of channels, one hop per payload
+     * @details
+     * Both nodes build the same hop sequence from the same channel set and seed, for example the quietest channels
+     * of a RF24L01_Scanner. A hop is one write of REGISTER::RF_CH with RF24L01::set_channel(), on the receiver with CE
+     * pulsed low around it, so the channel changes in standby. The transmitter hops after every send(), acknowledged
+     * or not. The receiver hops after every received payload, once the acknowledgement is send, so after a payload
+     * with an acknowledgement that's lost both nodes are on the next channel.
+     *
+     * Only a payload that's lost on all its transmissions leaves the receiver one channel behind. The receiver hops
+     * on its own when no payload arrives within resync_us, a bit longer than the time the transmitter needs for a
+     * MAX_RT, so both nodes step through a jammed channel together. After hopping the complete sequence without a
+     * payload, the receiver stays resync_us times the amount of channels on every channel, long enough for a
+     * transmitter that sends continuously to pass every channel once. A transmitter that's idle longer than resync_us
+     * resynchronizes that way, which costs up to one failed send() per channel.
+     * @tparam channels the amount of channels in the hop sequence
+     */
+    template<size_t channels>
+    class RF24L01_Hopper {
+        static_assert(channels > 0 and channels <= 128, "a hop sequence has 1-128 channels");
+    public:
+        /**
+         * @brief
+         * time in us the receiver keeps listening after a payload for its acknowledgement to be send
+         */
+        static constexpr uint_fast64_t ack_guard_us = 250;
+
+    private:
+        /**
+         * @brief
+         * RF24L01 object that hops
+         */
+        RF24L01 &chip;
+        /**
+         * @brief
+         * the channels in the order they are used
+         */
+        std::array<uint8_t, channels> sequence;
+        /**
+         * @brief
+         * index in sequence of the current channel
+         */
+        size_t position = 0;
+        /**
+         * @brief
+         * time in us the receiver waits for a payload before it hops on its own
+         */
+        uint_fast64_t resync_us;
+        /**
+         * @brief
+         * time in us of the last hop or, with hop_pending, of the last received payload
+         */
+        uint_fast64_t last_event = 0;
+        /**
+         * @brief
+         * boolean that's true if the receiver hops after the acknowledgement of a received payload
+         */
+        bool hop_pending = false;
+        /**
+         * @brief
+         * amount of hops of the receiver without a payload since the last payload
+         */
+        size_t misses = 0;
+        /**
+         * @brief
+         * amount of hops of the receiver without a payload
+         */
+        uint32_t resyncs = 0;
+
+        /**
+         * @brief
+         * function to get the time the receiver waits for a payload before it hops on its own
+         * @return uint_fast64_t resync_us, times the amount of channels after a complete sequence without a payload
+         */
+        uint_fast64_t dwell() const {
+            return misses < channels ? resync_us : resync_us * channels;
+        }
+
+    public:
+        /**
+         * @brief
+         * constructor for the RF24L01_Hopper
+         * @details
+         * The sequence is a permutation of channel_set, shuffled with a xorshift generator, and is repeated
+         * @param chip RF24L01 object with the address, payload width and retransmit settings of the link
+         * @param channel_set the channels to hop over, 0-127
+         * @param seed seed of the hop sequence, the same on both nodes
+         * @param resync_us time in us the receiver waits for a payload before it hops, a bit longer than a send() that
+         * ends with MAX_RT, default value = 2000
+         */
+        RF24L01_Hopper(RF24L01 &chip, const std::array<uint8_t, channels> &channel_set, uint32_t seed,
+                       uint_fast64_t resync_us = 2000) :
+                chip(chip), sequence(channel_set), resync_us(resync_us) {
+            uint32_t state = seed != 0 ? seed : 1;
+            for (size_t i = channels - 1; i > 0; i--) {
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+                const size_t j = state % (i + 1);
+                const uint8_t swap = sequence[i];
+                sequence[i] = sequence[j];
+                sequence[j] = swap;
+            }
+        }
+
+        /**
+         * @brief
+         * function to go to the first channel of the sequence, both nodes call start() before the first payload
+         */
+        void start() {
+            hop_to(0);
+        }
+
+        /**
+         * @brief
+         * function to go to the next channel of the sequence, one write of REGISTER::RF_CH
+         * @details
+         * In RX-mode CE is pulsed low around the write, the receiver listens again 130 us after the hop
+         */
+        void hop() {
+            hop_to(position + 1 < channels ? position + 1 : 0);
+        }
+
+        /**
+         * @brief
+         * function to go to a channel of the sequence
+         * @param index the index in the sequence, 0-channels
+         */
+        void hop_to(size_t index) {
+            position = index < channels ? index : 0;
+            chip.set_channel(sequence[position]);
+            last_event = hwlib::now_us();
+            hop_pending = false;
+        }
+
+        /**
+         * @brief
+         * function to get the current channel
+         * @return uint8_t the channel
+         */
+        uint8_t channel() const {
+            return sequence[position];
+        }
+
+        /**
+         * @brief
+         * function to get the index of the current channel in the sequence
+         * @return size_t the index
+         */
+        size_t index() const {
+            return position;
+        }
+
+        /**
+         * @brief
+         * function to get the channel at an index of the sequence
+         * @param i the index, 0-channels
+         * @return uint8_t the channel
+         */
+        uint8_t operator[](size_t i) const {
+            return sequence[i < channels ? i : 0];
+        }
+
+        /**
+         * @brief
+         * function to get the amount of times the receiver hopped without a payload
+         * @return uint32_t the amount of hops without a payload
+         */
+        uint32_t resync_count() const {
+            return resyncs;
+        }
+
+        /**
+         * @brief
+         * function to send a payload on the current channel and hop to the next one
+         * @param data the payload, in the byte order of RF24L01::write_tx() with a std::array
+         * @param timeout_us maximum time in μs to wait for the acknowledgement, default value = 100 ms
+         * @return boolean that's true if the payload is acknowledged
+         */
+        template<size_t amount>
+        bool send(const std::array<uint8_t, amount> &data, uint_fast64_t timeout_us = 100'000) {
+            const std::array<std::array<uint8_t, amount>, 1> payloads = {data};
+            const RF24L01::stream_result result = chip.stream_tx(payloads, timeout_us);
+            hop();
+            return not result.failed;
+        }
+
+        /**
+         * @brief
+         * function the receiver calls as often as possible to read a payload and to follow the hop sequence
+         * @details
+         * Costs one SPI-transaction for the status when there's no payload and no hop, the RF24L01 must be in RX-mode
+         * @param data buffer for the payload, in the byte order of RF24L01::read_rx() with a std::array
+         * @return boolean that's true if a payload is read in data
+         */
+        template<size_t amount>
+        bool receive(std::array<uint8_t, amount> &data) {
+            const uint_fast64_t now = hwlib::now_us();
+            if (hop_pending) {
+                if (now - last_event >= ack_guard_us) {
+                    hop();
+                }
+            } else if (now - last_event >= dwell()) {
+                hop();
+                resyncs++;
+                if (misses < channels) {
+                    misses++;
+                }
+            }
+            if (not chip.packet_received()) {
+                return false;
+            }
+            chip.read_rx(data);
+            hop_pending = true;
+            last_event = hwlib::now_us();
+            misses = 0;
+            return true;
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_HOPPER_H
@@ -0,0 +1,180 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_RX_Engine.hpp
+ *  @brief     IPASS-project: Interrupt driven receiver for the RF24L01.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_RX_ENGINE_H
+#define IPASS_RF24L01_RX_ENGINE_H
+
+#include "RF24L01.hpp"
+#include "../Ring_Buffer/Ring_Buffer.hpp"
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Interrupt driven receiver for the RF24L01
+     * @details
+     * The engine empties the 3 payload deep RX FIFO of the RF24L01 as soon as the IRQ-pin goes low and stores the
+     * payloads in a Ring_Buffer, so the main loop can pop the packets at its own pace without losing them in the FIFO.
+     * on_irq() is the producer and can be called from a falling edge interrupt handler of the IRQ-pin, pop() is the
+     * consumer. Without an interrupt handler the main loop calls poll() as often as possible.
+     * @tparam payload_size the amount of bytes in a payload, equal to the value written with RF24L01::change_RX_PW_P()
+     * @tparam capacity the amount of packets the ring buffer can store, must be a power of 2
+     */
+    template<size_t payload_size, size_t capacity>
+    class RF24L01_RX_Engine {
+    public:
+        /**
+         * @brief
+         * Struct packet that contains a received payload
+         */
+        struct packet {
+            /**
+             * @brief
+             * the pipe 0-5 on which the payload was received
+             */
+            uint8_t pipe;
+            /**
+             * @brief
+             * the payload, in the same byte order as RF24L01::read_rx()
+             */
+            std::array<uint8_t, payload_size> data;
+        };
+
+    private:
+        /**
+         * @brief
+         * RF24L01 object the packets are read from
+         */
+        RF24L01 &chip;
+        /**
+         * @brief
+         * Ring_Buffer that contains the received packets
+         */
+        Ring_Buffer<packet, capacity> packets;
+        /**
+         * @brief
+         * Payload that's read from the RF24L01 when the ring buffer is full
+         */
+        std::array<uint8_t, payload_size> discarded = {};
+        /**
+         * @brief
+         * amount of packets that are dropped because the ring buffer was full
+         */
+        uint32_t ring_overflows = 0;
+        /**
+         * @brief
+         * amount of times the RX FIFO of the RF24L01 was full when it was emptied, in that case the RF24L01 could have
+         * dropped packets
+         */
+        uint32_t fifo_full_events = 0;
+
+    public:
+        /**
+         * @brief
+         * constructor for the RF24L01_RX_Engine
+         * @param chip RF24L01 object that's in RX-mode, see RF24L01::start_RX()
+         */
+        explicit RF24L01_RX_Engine(RF24L01 &chip) :
+                chip(chip) {}
+
+        /**
+         * @brief
+         * Producer: function to move all payloads from the RX FIFO of the RF24L01 to the ring buffer
+         * @details
+         * Uses the RX_P_NO-value of the STATUS byte to check if there is a payload, reads it directly into the ring
+         * buffer and clears RX_DR when the FIFO is empty. The STATUS byte of that clear is checked again, so a payload
+         * that arrives during the clear is not left behind.
+         */
+        void on_irq() {
+            chip.update_status();
+            uint8_t pipe = chip.last_pipe();
+            for (;;) {
+                uint_fast8_t read_payloads = 0;
+                while (pipe != 0x07) {
+                    packet *slot = packets.producer_slot();
+                    if (slot == nullptr) {
+                        chip.read_rx(discarded);
+                        ring_overflows++;
+                    } else {
+                        slot->pipe = pipe;
+                        chip.read_rx(slot->data);
+                        packets.commit();
+                    }
+                    read_payloads++;
+                    chip.update_status();
+                    pipe = chip.last_pipe();
+                }
+                if (read_payloads >= 3) {
+                    fifo_full_events++;
+                }
+                chip.register_write(RF24L01::REGISTER::STATUS, RF24L01::SETTING::RX_DR.Mask);
+                pipe = chip.last_pipe();
+                if (pipe == 0x07) {
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief
+         * function to call from the main loop when the IRQ-pin has no interrupt handler
+         * @details
+         * Checks the level of the IRQ-pin, which costs no SPI-transaction, and calls on_irq() when it is low
+         */
+        void poll() {
+            if (chip.interrupt_pending()) {
+                on_irq();
+            }
+        }
+
+        /**
+         * @brief
+         * Consumer: function to get the oldest received packet
+         * @param packet_out the oldest packet is stored in this parameter
+         * @return returns false if there is no packet
+         */
+        bool pop(packet &packet_out) {
+            return packets.pop(packet_out);
+        }
+
+        /**
+         * @brief
+         * function to get the amount of packets in the ring buffer
+         * @return size_t amount of packets
+         */
+        size_t available() const {
+            return packets.size();
+        }
+
+        /**
+         * @brief
+         * function to get the amount of packets dropped because the ring buffer was full
+         * @return uint32_t amount of dropped packets
+         */
+        uint32_t overflow_count() const {
+            return ring_overflows;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of times the RX FIFO of the RF24L01 was full when it was emptied
+         * @return uint32_t amount of full RX FIFO events
+         */
+        uint32_t fifo_full_count() const {
+            return fifo_full_events;
+        }
+
+        /**
+         * @brief
+         * function to reset the overflow counters
+         */
+        void reset_counters() {
+            ring_overflows = 0;
+            fifo_full_events = 0;
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_RX_ENGINE_H
@@ -1,85 +0,0 @@
-#include "RF24L01.hpp"
-
-namespace IPASS {
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::R_REGISTER = 0x00;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::W_REGISTER = 0x20;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::R_RX_PAYLOAD = 0x61;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::W_TX_PAYLOAD = 0xA0;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::FLUSH_TX = 0xE1;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::FLUSH_RX = 0xE2;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::REUSE_TX_PL = 0xE3;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::ACTIVATE = 0x50;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::R_RX_PL_WID = 0x60;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::W_ACK_PAYLOAD = 0xa8;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::W_TX_PAYLOAD_NO_ACK = 0xb0;
-    [[maybe_unused]] const uint8_t RF24L01::COMMAND::NOP = 0xff;
-
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::CONFIG = 0x00;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::EN_AA = 0x01;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::EN_RXADDR = 0x02;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::SETUP_AW = 0x03;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::SETUP_RETR = 0x04;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RF_CH = 0x05;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RF_SETUP = 0x06;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::STATUS = 0x07;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::OBSERVE_TX = 0x08;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::CD = 0x09;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_ADDR_P0 = 0x0A;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_ADDR_P1 = 0x0B;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_ADDR_P2 = 0x0C;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_ADDR_P3 = 0x0D;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_ADDR_P4 = 0x0E;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_ADDR_P5 = 0x0F;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::TX_ADDR = 0x10;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_PW_P0 = 0x11;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_PW_P1 = 0x12;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_PW_P2 = 0x13;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_PW_P3 = 0x14;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_PW_P4 = 0x15;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::RX_PW_P5 = 0x16;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::FIFO_STATUS = 0x17;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::DYNPD = 0x1C;
-    [[maybe_unused]] const uint8_t RF24L01::REGISTER::FEATURE = 0x1D;
-
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::Mask_RX_DR = {RF24L01::REGISTER::CONFIG, 0x40, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::Mask_TX_DS = {RF24L01::REGISTER::CONFIG, 0x20, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::Mask_MAX_RT = {RF24L01::REGISTER::CONFIG, 0x10, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::EN_CRC = {RF24L01::REGISTER::CONFIG, 0x08,1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::CRCO = {RF24L01::REGISTER::CONFIG, 0x04, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::PWR_UP = {RF24L01::REGISTER::CONFIG, 0x02, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::PRIM_RX = {RF24L01::REGISTER::CONFIG, 0x01, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ENAA_P5 = {RF24L01::REGISTER::EN_AA, 0x20, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ENAA_P4 = {RF24L01::REGISTER::EN_AA, 0x10, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ENAA_P3 = {RF24L01::REGISTER::EN_AA, 0x08, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ENAA_P2 = {RF24L01::REGISTER::EN_AA, 0x04, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ENAA_P1 = {RF24L01::REGISTER::EN_AA, 0x02, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ENAA_P0 = {RF24L01::REGISTER::EN_AA, 0x01, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ERX_P5 = {RF24L01::REGISTER::EN_RXADDR, 0x20, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ERX_P4 = {RF24L01::REGISTER::EN_RXADDR, 0x10, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ERX_P3 = {RF24L01::REGISTER::EN_RXADDR, 0x08, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ERX_P2 = {RF24L01::REGISTER::EN_RXADDR, 0x04, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ERX_P1 = {RF24L01::REGISTER::EN_RXADDR, 0x02, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::ERX_P0 = {RF24L01::REGISTER::EN_RXADDR, 0x01, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::PLL_LOCK = {RF24L01::REGISTER::RF_SETUP, 0x10, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::RF_DR = {RF24L01::REGISTER::RF_SETUP, 0x08, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::LNA_HCURR = {RF24L01::REGISTER::RF_SETUP, 0x01, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::RX_DR = {RF24L01::REGISTER::STATUS, 0x40, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::TX_DS = {RF24L01::REGISTER::STATUS, 0x20, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::MAX_RT = {RF24L01::REGISTER::STATUS, 0x10, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::CD = {RF24L01::REGISTER::CD, 0x01, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::TX_REUSE = {RF24L01::REGISTER::FIFO_STATUS, 0x10, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::TX_FULL = {RF24L01::REGISTER::FIFO_STATUS, 0x20, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::TX_EMPTY = {RF24L01::REGISTER::FIFO_STATUS, 0x10, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::RX_FULL = {RF24L01::REGISTER::FIFO_STATUS, 0x02, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::RX_EMPTY = {RF24L01::REGISTER::FIFO_STATUS, 0x01, 1};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::DPL_P5 = {RF24L01::REGISTER::DYNPD, 0x20, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::DPL_P4 = {RF24L01::REGISTER::DYNPD, 0x10, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::DPL_P3 = {RF24L01::REGISTER::DYNPD, 0x08, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::DPL_P2 = {RF24L01::REGISTER::DYNPD, 0x04, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::DPL_P1 = {RF24L01::REGISTER::DYNPD, 0x02, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::DPL_P0 = {RF24L01::REGISTER::DYNPD, 0x01, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::EN_DPL = {RF24L01::REGISTER::FEATURE, 0x04, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::EN_ACK_PAY = {RF24L01::REGISTER::FEATURE, 0x02, 0};
-    [[maybe_unused]] RF24L01::SETTING::Setting RF24L01::SETTING::EN_DYN_ACK = {RF24L01::REGISTER::FEATURE, 0x01, 0};
-
-}
\ No newline at end of file
@@ -0,0 +1,212 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Scanner.hpp
+ *  @brief     IPASS-project: Carrier detect survey of the RF-channels of the RF24L01.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_SCANNER_H
+#define IPASS_RF24L01_SCANNER_H
+
+#include "RF24L01.hpp"
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Scanner that counts per RF-channel how often REGISTER::CD reports a carrier
+     * @details
+     * The RF24L01 is in RX-mode during the whole sweep. A hop is a write of REGISTER::RF_CH with RF24L01::set_channel(),
+     * which pulses CE low around the write so the channel changes in standby, the dwell time and a read of
+     * REGISTER::CD, so a hop costs 2 SPI-transactions and 2 pin writes. CD is only valid 130 us after CE is high again,
+     * so the dwell time must be longer than that. After the scan the channel and REGISTER::CONFIG of before the scan
+     * are written back:
+     * @code
+     * IPASS::RF24L01_Scanner scanner(chip);
+     * scanner.scan(20);
+     * std::array<uint8_t, 3> channels = scanner.quietest<3>();
+     * @endcode
+     */
+    class RF24L01_Scanner {
+    private:
+        /**
+         * @brief
+         * RF24L01 object the channels are scanned with
+         */
+        RF24L01 &chip;
+        /**
+         * @brief
+         * time in us the scanner listens on a channel before CD is read
+         */
+        uint32_t dwell_us;
+        /**
+         * @brief
+         * the first channel of a sweep
+         */
+        uint8_t first;
+        /**
+         * @brief
+         * the last channel of a sweep
+         */
+        uint8_t last;
+        /**
+         * @brief
+         * amount of sweeps with a carrier per channel
+         */
+        std::array<uint16_t, 128> hits = {};
+        /**
+         * @brief
+         * amount of sweeps since the last reset()
+         */
+        uint16_t sweeps = 0;
+
+        /**
+         * @brief
+         * function to get the hits of a channel and its neighbours, a wide carrier on a neighbour also disturbs a
+         * 2 Mbps link on the channel
+         * @param channel the channel first-last
+         * @return uint32_t the hits of the channel below and above
+         */
+        uint32_t neighbour_hits(uint8_t channel) const {
+            uint32_t result = 0;
+            if (channel > first) {
+                result += hits[channel - 1];
+            }
+            if (channel < last) {
+                result += hits[channel + 1];
+            }
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to compare the occupancy of two channels
+         * @param a the first channel
+         * @param b the second channel
+         * @return boolean that's true if a is quieter than b: less hits, less hits on the neighbours or a lower channel
+         */
+        bool quieter(uint8_t a, uint8_t b) const {
+            if (hits[a] != hits[b]) {
+                return hits[a] < hits[b];
+            }
+            if (neighbour_hits(a) != neighbour_hits(b)) {
+                return neighbour_hits(a) < neighbour_hits(b);
+            }
+            return a < b;
+        }
+
+    public:
+        /**
+         * @brief
+         * constructor for the RF24L01_Scanner
+         * @param chip RF24L01 object with the data rate of the link that's planned
+         * @param dwell_us time in us the scanner listens on a channel, default value = 200
+         * @param first the first channel of a sweep, default value = 0
+         * @param last the last channel of a sweep, default value = 125
+         */
+        explicit RF24L01_Scanner(RF24L01 &chip, uint32_t dwell_us = 200, uint8_t first = 0, uint8_t last = 125) :
+                chip(chip), dwell_us(dwell_us), first(first < 128 ? first : 127),
+                last(last < 128 ? (last < first ? first : last) : 127) {}
+
+        /**
+         * @brief
+         * function to sweep the channels
+         * @details
+         * Costs 2 SPI-transactions per channel per sweep, and 8 to 10 SPI-transactions to start RX-mode and to write the
+         * channel and REGISTER::CONFIG back. A chip that was in TX-mode has CE low after the scan.
+         * @param repetitions the amount of sweeps, default value = 1
+         */
+        void scan(uint16_t repetitions = 1) {
+            const uint8_t channel = chip.register_read(RF24L01::REGISTER::RF_CH);
+            const uint8_t config = chip.register_read(RF24L01::REGISTER::CONFIG);
+            chip.start_RX();
+            for (uint16_t sweep = 0; sweep < repetitions; sweep++) {
+                for (uint16_t hop = first; hop <= last; hop++) {
+                    chip.set_channel(hop);
+                    hwlib::wait_us(dwell_us);
+                    if (chip.register_read(RF24L01::REGISTER::CD) & RF24L01::SETTING::CD.Mask) {
+                        hits[hop]++;
+                    }
+                }
+                sweeps++;
+            }
+            chip.set_channel(channel);
+            if (not(config & RF24L01::SETTING::PRIM_RX.Mask)) {
+                chip.stop_RX();
+            }
+            chip.register_write(RF24L01::REGISTER::CONFIG, config);
+        }
+
+        /**
+         * @brief
+         * function to get the occupancy of a channel
+         * @param channel the channel 0-127
+         * @return uint16_t amount of sweeps with a carrier on the channel
+         */
+        uint16_t occupancy(uint8_t channel) const {
+            return channel < 128 ? hits[channel] : 0;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of sweeps
+         * @return uint16_t amount of sweeps since the last reset()
+         */
+        uint16_t sweep_count() const {
+            return sweeps;
+        }
+
+        /**
+         * @brief
+         * function to print the channels with a carrier and their occupancy in sweeps
+         */
+        void print() const {
+            hwlib::cout << sweeps << " sweeps, channel: hits\n";
+            for (uint16_t channel = first; channel <= last; channel++) {
+                if (hits[channel] > 0) {
+                    hwlib::cout << channel << ": " << hits[channel] << '\n';
+                }
+            }
+        }
+
+        /**
+         * @brief
+         * function to get the quietest channels
+         * @details
+         * The channels are ranked on their hits, then on the hits of the channels next to them, then on channel number
+         * @tparam amount the amount of channels, at most the amount of channels of a sweep
+         * @return std::array with the quietest channel first
+         */
+        template<size_t amount>
+        std::array<uint8_t, amount> quietest() const {
+            static_assert(amount > 0 and amount <= 128, "a sweep has 1-128 channels");
+            std::array<uint8_t, amount> result = {};
+            size_t ranked = 0;
+            for (uint16_t channel = first; channel <= last; channel++) {
+                size_t i = ranked < amount ? ranked : amount;
+                while (i > 0 and quieter(channel, result[i - 1])) {
+                    if (i < amount) {
+                        result[i] = result[i - 1];
+                    }
+                    i--;
+                }
+                if (i < amount) {
+                    result[i] = channel;
+                    if (ranked < amount) {
+                        ranked++;
+                    }
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief
+         * function to clear the histogram
+         */
+        void reset() {
+            hits = {};
+            sweeps = 0;
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_SCANNER_H
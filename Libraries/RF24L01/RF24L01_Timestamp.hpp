@@ -0,0 +1,386 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Timestamp.hpp
+ *  @brief     IPASS-project: Payload header with a transmit timestamp and sequence number, and a one-way latency
+ *             estimator for the receiver.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_TIMESTAMP_H
+#define IPASS_RF24L01_TIMESTAMP_H
+
+#include "RF24L01.hpp"
+#include <array>
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Transmitter side: puts a header with a sequence number and the transmit time in front of a payload
+     * @details
+     * The header is header_size bytes: the sequence number and the lowest 24 bits of the clock in us, so the
+     * timestamp wraps every 16.7 s and the sequence number every 256 payloads. The receiver reads it with a
+     * RF24L01_Latency_Estimator. The header is written just before the payload is written to the RF24L01, so the
+     * latency includes the time in the TX FIFO.
+     * @code
+     * IPASS::RF24L01_Timestamper stamper;
+     * const uint8_t data[4] = {0x10, 0x20, 0x30, 0x40};
+     * stamper.write_tx(chip, data, 4);
+     * chip.send_packages();
+     * @endcode
+     */
+    class RF24L01_Timestamper {
+    public:
+        /**
+         * @brief
+         * amount of bytes of the header
+         */
+        static constexpr size_t header_size = 4;
+
+        /**
+         * @brief
+         * Clock in us: hwlib::now_us(), or a clock with an offset and skew on the host
+         */
+        using clock = uint_fast64_t (*)();
+
+    private:
+        /**
+         * @brief
+         * the clock of the timestamps
+         */
+        clock source;
+        /**
+         * @brief
+         * sequence number of the next payload
+         */
+        uint8_t sequence = 0;
+
+    public:
+        /**
+         * @brief
+         * constructor for the RF24L01_Timestamper
+         * @param source the clock of the timestamps, default value = hwlib::now_us
+         */
+        explicit RF24L01_Timestamper(clock source = hwlib::now_us) :
+                source(source) {}
+
+        /**
+         * @brief
+         * function to get the sequence number of the next payload
+         * @return uint8_t the sequence number
+         */
+        uint8_t next_sequence() const {
+            return sequence;
+        }
+
+        /**
+         * @brief
+         * function to write the header with the current time and the next sequence number
+         * @param header buffer of header_size bytes, in front of the data of the payload
+         */
+        void stamp(uint8_t header[]) {
+            const uint_fast64_t now = source();
+            header[0] = sequence++;
+            header[1] = uint8_t(now);
+            header[2] = uint8_t(now >> 8);
+            header[3] = uint8_t(now >> 16);
+        }
+
+        /**
+         * @brief
+         * function to write a payload with the header to the TX FIFO with RF24L01::write_tx()
+         * @param chip RF24L01 object in TX-mode
+         * @param data buffer that contains the data, data[0] is send after the header
+         * @param length amount of bytes in data, at most 32 - header_size
+         * @param no_ack send the payload without acknowledgement, default value = false
+         * @return boolean that's false if the data doesn't fit in a payload
+         */
+        bool write_tx(RF24L01 &chip, const uint8_t data[], size_t length, bool no_ack = false) {
+            if (length > 32 - header_size) {
+                return false;
+            }
+            uint8_t payload[32];
+            for (size_t i = 0; i < length; i++) {
+                payload[header_size + i] = data[i];
+            }
+            stamp(payload);
+            chip.write_tx(payload, header_size + length, no_ack);
+            return true;
+        }
+    };
+
+    /**
+     * @brief
+     * Receiver side: one-way latency, jitter and loss of the payloads of a RF24L01_Timestamper
+     * @details
+     * The clocks of the transmitter and the receiver have an unknown offset and run at a slightly different rate, a
+     * crystal is about 20-100 ppm off. So the difference between the receive time and the timestamp is the latency plus
+     * an offset that drifts. The estimator takes the fastest payload of every window of payloads as the lower bound of
+     * that difference. The slope of the line through the minimum of the first and of the last window is the skew of the
+     * clocks, and the lowest line with that slope through the minima of the last 8 windows is the lower bound. The
+     * latency of a payload is its difference above that bound plus floor_us, the latency of the fastest payload, which
+     * can't be seen without a round trip: at least the 130 us settling of the transmitter and the air time, see
+     * air_time_us().
+     * The jitter is the interarrival jitter of RFC 3550, which doesn't depend on the offset. A gap in the sequence
+     * numbers counts as lost payloads, so at most 255 payloads in a row can be lost.
+     * @code
+     * IPASS::RF24L01_Latency_Estimator estimator(130 + IPASS::RF24L01_Latency_Estimator::air_time_us(8));
+     * uint8_t payload[8];
+     * if (chip.packet_received()) {
+     *     chip.read_rx(payload, 8);
+     *     histogram.record(estimator.record(payload));
+     * }
+     * @endcode
+     */
+    class RF24L01_Latency_Estimator {
+    private:
+        /**
+         * @brief
+         * Struct minimum with the fastest payload of a window
+         */
+        struct minimum {
+            ///difference between the receive time and the timestamp in us
+            int_fast64_t difference;
+            ///receive time in us
+            int_fast64_t time;
+        };
+
+        /**
+         * @brief
+         * the clock of the receiver
+         */
+        RF24L01_Timestamper::clock source;
+        /**
+         * @brief
+         * latency in us of the fastest payload
+         */
+        uint32_t floor_us;
+        /**
+         * @brief
+         * amount of payloads per window of the lower bound
+         */
+        uint32_t window;
+        /**
+         * @brief
+         * difference between the receive time and the unwrapped timestamp of the last payload in us
+         */
+        int_fast64_t last_difference = 0;
+        /**
+         * @brief
+         * sequence number of the last payload
+         */
+        uint8_t last_sequence = 0;
+        /**
+         * @brief
+         * amount of received payloads
+         */
+        uint32_t received_count = 0;
+        /**
+         * @brief
+         * amount of payloads missing in the sequence numbers
+         */
+        uint32_t lost_count = 0;
+        /**
+         * @brief
+         * amount of payloads received again with the same sequence number
+         */
+        uint32_t duplicate_count = 0;
+        /**
+         * @brief
+         * interarrival jitter in 1/16 us
+         */
+        uint32_t jitter_16 = 0;
+        /**
+         * @brief
+         * the last estimated latency in us
+         */
+        uint32_t last_latency = 0;
+        /**
+         * @brief
+         * amount of payloads in the current window
+         */
+        uint32_t window_count = 0;
+        /**
+         * @brief
+         * the fastest payload of the current window
+         */
+        minimum current = {};
+        /**
+         * @brief
+         * the fastest payload of the first window, the start of the line of the skew
+         */
+        minimum first = {};
+        /**
+         * @brief
+         * the fastest payloads of the last windows, the newest at index (windows - 1) % minima.size()
+         */
+        std::array<minimum, 8> minima = {};
+        /**
+         * @brief
+         * amount of complete windows
+         */
+        uint32_t windows = 0;
+        /**
+         * @brief
+         * slope of the lower bound: change of the difference in 1/1'000'000'000 us per us
+         */
+        int_fast64_t slope_ppb = 0;
+
+        /**
+         * @brief
+         * function to get the lower bound of the difference at a time
+         * @details
+         * The lowest of the lines with the slope through the fastest payloads of the last windows and the current
+         * window, so one window without a fast payload doesn't move the bound
+         * @param time receive time in us
+         * @return int_fast64_t the lower bound in us
+         */
+        int_fast64_t lower_bound(int_fast64_t time) const {
+            int_fast64_t bound = window_count > 0 ? current.difference : INT_FAST64_MAX;
+            for (size_t i = 0; i < windows and i < minima.size(); i++) {
+                const int_fast64_t line = minima[i].difference + slope_ppb * (time - minima[i].time) / 1'000'000'000;
+                bound = line < bound ? line : bound;
+            }
+            return bound;
+        }
+
+    public:
+        /**
+         * @brief
+         * constructor for the RF24L01_Latency_Estimator
+         * @param floor_us latency of the fastest payload in us, default value = 0 for the latency above the fastest
+         * @param window amount of payloads per window of the lower bound, default value = 16
+         * @param source the clock of the receiver, default value = hwlib::now_us
+         */
+        explicit RF24L01_Latency_Estimator(uint32_t floor_us = 0, uint32_t window = 16,
+                                           RF24L01_Timestamper::clock source = hwlib::now_us) :
+                source(source), floor_us(floor_us), window(window > 0 ? window : 1) {}
+
+        /**
+         * @brief
+         * function to calculate the air time of a payload
+         * @param length amount of bytes in the payload, with the header
+         * @param data_rate_2mbps boolean that's true for 2 Mbps, default value = false for 1 Mbps
+         * @param address_width amount of bytes of the address, default value = 5
+         * @param crc_bytes amount of bytes of the CRC, default value = 2
+         * @return uint32_t air time in us: preamble, address, packet control field, payload and CRC
+         */
+        static constexpr uint32_t air_time_us(size_t length, bool data_rate_2mbps = false, size_t address_width = 5,
+                                              size_t crc_bytes = 2) {
+            const uint32_t bits = 8 + 8 * address_width + 9 + 8 * length + 8 * crc_bytes;
+            return data_rate_2mbps ? (bits + 1) / 2 : bits;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of payloads received twice
+         * @return uint32_t amount of duplicates
+         */
+        uint32_t duplicates() const {
+            return duplicate_count;
+        }
+
+        /**
+         * @brief
+         * function to get the interarrival jitter of RFC 3550
+         * @return uint32_t jitter in us
+         */
+        uint32_t jitter_us() const {
+            return jitter_16 >> 4;
+        }
+
+        /**
+         * @brief
+         * function to get the latency of the last payload
+         * @return uint32_t latency in us
+         */
+        uint32_t latency_us() const {
+            return last_latency;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of lost payloads
+         * @return uint32_t amount of payloads missing in the sequence numbers
+         */
+        uint32_t lost() const {
+            return lost_count;
+        }
+
+        /**
+         * @brief
+         * function to get the estimated offset of the clocks now, the receiver clock minus the transmitter clock
+         * @return int_fast64_t offset in us within the 24 bits of the timestamps, without floor_us
+         */
+        int_fast64_t offset_us() const {
+            return lower_bound(int_fast64_t(source())) - floor_us;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of received payloads
+         * @return uint32_t amount of payloads
+         */
+        uint32_t received() const {
+            return received_count;
+        }
+
+        /**
+         * @brief
+         * function to handle a received payload
+         * @details
+         * Call it directly after RF24L01::read_rx(), the receive time is the time of the call
+         * @param payload the payload with the header of a RF24L01_Timestamper in front
+         * @return uint32_t the estimated one-way latency in us, or the last one for a duplicate
+         */
+        uint32_t record(const uint8_t payload[]) {
+            const int_fast64_t now = int_fast64_t(source());
+            const uint32_t timestamp = payload[1] | (uint32_t(payload[2]) << 8) | (uint32_t(payload[3]) << 16);
+            //difference within 24 bits, unwrapped with the last difference
+            int_fast64_t difference = (now - timestamp) & 0xFFFFFF;
+            if (received_count > 0) {
+                int_fast64_t change = (difference - last_difference) & 0xFFFFFF;
+                difference = last_difference + (change >= 0x800000 ? change - 0x1000000 : change);
+                const uint8_t gap = payload[0] - last_sequence;
+                if (gap == 0) {
+                    duplicate_count++;
+                    return last_latency;
+                }
+                lost_count += gap - 1;
+                const int_fast64_t transit = difference - last_difference;
+                jitter_16 += uint32_t(transit < 0 ? -transit : transit) - ((jitter_16 + 8) >> 4);
+            }
+            received_count++;
+            last_sequence = payload[0];
+            last_difference = difference;
+
+            if (window_count == 0 or difference < current.difference) {
+                current = {difference, now};
+            }
+            window_count++;
+            const int_fast64_t bound = lower_bound(now);
+            last_latency = uint32_t(difference > bound ? difference - bound : 0) + floor_us;
+            if (window_count == window) {
+                if (windows == 0) {
+                    first = current;
+                } else if (current.time > first.time) {
+                    slope_ppb = (current.difference - first.difference) * 1'000'000'000 / (current.time - first.time);
+                }
+                minima[windows % minima.size()] = current;
+                windows++;
+                window_count = 0;
+            }
+            return last_latency;
+        }
+
+        /**
+         * @brief
+         * function to get the estimated skew of the transmitter clock
+         * @return int32_t the rate of the transmitter clock relative to the receiver clock in parts per billion,
+         * positive if the transmitter clock is fast
+         */
+        int32_t skew_ppb() const {
+            return int32_t(-slope_ppb);
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_TIMESTAMP_H
@@ -0,0 +1,391 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Transport.hpp
+ *  @brief     IPASS-project: Fragmentation and reassembly of messages larger than one RF24L01 payload.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_TRANSPORT_H
+#define IPASS_RF24L01_TRANSPORT_H
+
+#include "RF24L01.hpp"
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Layout of the fragments of RF24L01_Transport_TX and RF24L01_Reassembler
+     * @details
+     * Every fragment is one payload of fragment_size bytes, in the byte order of RF24L01::write_tx() with a std::array:
+     * - [0]: message id, the same for all fragments of one message
+     * - [1]: index of the fragment in the message
+     * - [2]: amount of fragments in the message, 1-255
+     * - [3]: amount of bytes of the message in this fragment
+     * - [4]: the bytes of the message, the last fragment is padded with 0
+     * @tparam fragment_size the payload width of the pipe, 5-32
+     */
+    template<size_t fragment_size>
+    class RF24L01_Fragment {
+        static_assert(fragment_size > 4 and fragment_size <= 32, "a fragment is a payload of 5-32 bytes");
+    public:
+        /**
+         * @brief
+         * amount of bytes of the header
+         */
+        static constexpr size_t header_size = 4;
+        /**
+         * @brief
+         * amount of bytes of the message in one fragment
+         */
+        static constexpr size_t data_size = fragment_size - header_size;
+        /**
+         * @brief
+         * maximum length of a message
+         */
+        static constexpr size_t max_message = 255 * data_size;
+
+        /**
+         * @brief
+         * Container of the fragments of one message, a fragment is made when it's indexed
+         * @details
+         * Has the size() and operator[] that RF24L01::stream_tx() uses, so the fragments are not stored
+         */
+        class view {
+        private:
+            /**
+             * @brief
+             * the message
+             */
+            const uint8_t *data;
+            /**
+             * @brief
+             * amount of bytes of the message
+             */
+            size_t length;
+            /**
+             * @brief
+             * the message id
+             */
+            uint8_t message_id;
+            /**
+             * @brief
+             * index of the first fragment of the view, to resend the fragments from a failed one
+             */
+            size_t first;
+        public:
+            /**
+             * @brief
+             * constructor for view
+             * @param data the message, must stay valid during the lifetime of the view
+             * @param length amount of bytes of the message, 1-max_message
+             * @param message_id the message id
+             * @param first index of the first fragment, default value = 0
+             */
+            view(const uint8_t data[], size_t length, uint8_t message_id, size_t first = 0) :
+                    data(data), length(length), message_id(message_id), first(first) {}
+
+            /**
+             * @brief
+             * function to get the amount of fragments of a message
+             * @param length amount of bytes of the message
+             * @return size_t amount of fragments
+             */
+            static size_t count(size_t length) {
+                return (length + data_size - 1) / data_size;
+            }
+
+            /**
+             * @brief
+             * function to get the amount of fragments in the view
+             * @return size_t amount of fragments from first
+             */
+            size_t size() const {
+                return count(length) - first;
+            }
+
+            /**
+             * @brief
+             * function to make a fragment
+             * @param i index in the view, fragment first + i of the message
+             * @return std::array with the fragment
+             */
+            std::array<uint8_t, fragment_size> operator[](size_t i) const {
+                const size_t index = first + i;
+                const size_t offset = index * data_size;
+                const size_t bytes = length - offset < data_size ? length - offset : data_size;
+                std::array<uint8_t, fragment_size> fragment = {message_id, uint8_t(index), uint8_t(count(length)),
+                                                               uint8_t(bytes)};
+                for (size_t b = 0; b < bytes; b++) {
+                    fragment[header_size + b] = data[offset + b];
+                }
+                return fragment;
+            }
+        };
+    };
+
+    /**
+     * @brief
+     * Transmitter that sends messages larger than one payload as numbered fragments
+     * @details
+     * The fragments are streamed back-to-back through the TX FIFO with RF24L01::stream_tx(), a fragment is made when
+     * it's written to the RF24L01, so a message costs no memory besides the message itself. After MAX_RT the
+     * fragments from the failed one are send again. The receiver uses a RF24L01_Reassembler with the same
+     * fragment_size as width of the pipe.
+     * @tparam fragment_size the payload width of the pipe, 5-32
+     */
+    template<size_t fragment_size>
+    class RF24L01_Transport_TX {
+    private:
+        /**
+         * @brief
+         * RF24L01 object the fragments are send with
+         */
+        RF24L01 &chip;
+        /**
+         * @brief
+         * message id of the next message
+         */
+        uint8_t next_id = 0;
+
+    public:
+        /**
+         * @brief
+         * the fragment layout
+         */
+        using fragment = RF24L01_Fragment<fragment_size>;
+
+        /**
+         * @brief
+         * constructor for RF24L01_Transport_TX
+         * @param chip RF24L01 object in TX-mode with a TX_ADDR and a payload width of fragment_size
+         */
+        explicit RF24L01_Transport_TX(RF24L01 &chip) :
+                chip(chip) {}
+
+        /**
+         * @brief
+         * function to send a message
+         * @param data the message
+         * @param length amount of bytes of the message, 1-fragment::max_message
+         * @param attempts amount of times the fragments from a failed one are streamed again, default value = 3
+         * @return boolean that's true if all fragments are acknowledged
+         */
+        bool send(const uint8_t data[], size_t length, uint8_t attempts = 3) {
+            if (length == 0 or length > fragment::max_message) {
+                return false;
+            }
+            const uint8_t message_id = next_id++;
+            size_t first = 0;
+            for (uint8_t attempt = 0; attempt <= attempts; attempt++) {
+                typename fragment::view fragments(data, length, message_id, first);
+                RF24L01::stream_result result = chip.stream_tx(fragments);
+                if (not result.failed) {
+                    return true;
+                }
+                first += result.failed_index;
+            }
+            return false;
+        }
+    };
+
+    /**
+     * @brief
+     * Receiver that puts the fragments of RF24L01_Transport_TX together in a preallocated buffer
+     * @details
+     * Every fragment is copied to its place in the buffer, a bitmap marks the received fragments. A fragment that's
+     * already received is counted as duplicate and ignored. When the first fragment of a new message arrives before the
+     * current message is complete, the current message is dropped and its missing fragments are counted as gap.
+     * @tparam fragment_size the payload width of the pipe, 5-32
+     * @tparam max_length the size of the buffer, the maximum length of a message
+     */
+    template<size_t fragment_size, size_t max_length>
+    class RF24L01_Reassembler {
+    public:
+        /**
+         * @brief
+         * the fragment layout
+         */
+        using fragment = RF24L01_Fragment<fragment_size>;
+
+    private:
+        static_assert(max_length > 0 and max_length <= fragment::max_message, "max_length doesn't fit 255 fragments");
+        /**
+         * @brief
+         * the message that's put together
+         */
+        std::array<uint8_t, max_length> buffer = {};
+        /**
+         * @brief
+         * bitmap with a bit per received fragment
+         */
+        std::array<uint32_t, 8> received = {};
+        /**
+         * @brief
+         * boolean that's true while a message is put together
+         */
+        bool busy = false;
+        /**
+         * @brief
+         * boolean that's true if the message in the buffer is complete
+         */
+        bool done = false;
+        /**
+         * @brief
+         * message id of the message in the buffer
+         */
+        uint8_t message_id = 0;
+        /**
+         * @brief
+         * amount of fragments of the message in the buffer
+         */
+        uint8_t count = 0;
+        /**
+         * @brief
+         * amount of fragments of the message in the buffer that are received
+         */
+        uint8_t received_count = 0;
+        /**
+         * @brief
+         * length of the message in the buffer, known when the last fragment is received
+         */
+        size_t length = 0;
+        /**
+         * @brief
+         * amount of fragments that were already received
+         */
+        uint32_t duplicates = 0;
+        /**
+         * @brief
+         * amount of fragments that were missing from dropped messages
+         */
+        uint32_t gaps = 0;
+        /**
+         * @brief
+         * amount of fragments with a header that's not valid or a message that doesn't fit the buffer
+         */
+        uint32_t invalid = 0;
+
+    public:
+        /**
+         * @brief
+         * function to pass a received fragment
+         * @param data the fragment as read with RF24L01::read_rx() with a std::array
+         * @return boolean that's true if this fragment completed the message, see message() and message_length()
+         */
+        bool on_fragment(const std::array<uint8_t, fragment_size> &data) {
+            const uint8_t id = data[0];
+            const uint8_t index = data[1];
+            const uint8_t fragments = data[2];
+            const uint8_t bytes = data[3];
+            const size_t offset = index * fragment::data_size;
+            if (fragments == 0 or index >= fragments or bytes == 0 or bytes > fragment::data_size or
+                offset + bytes > max_length or (index + 1 < fragments and bytes != fragment::data_size)) {
+                invalid++;
+                return false;
+            }
+            if ((busy or done) and id == message_id and fragments == count) {
+                if (received[index / 32] & (1UL << (index % 32))) {
+                    duplicates++;
+                    return false;
+                }
+            } else {
+                if (busy) {
+                    gaps += count - received_count;
+                }
+                busy = true;
+                done = false;
+                message_id = id;
+                count = fragments;
+                received_count = 0;
+                received = {};
+            }
+            for (size_t b = 0; b < bytes; b++) {
+                buffer[offset + b] = data[fragment::header_size + b];
+            }
+            if (index + 1 == fragments) {
+                length = offset + bytes;
+            }
+            received[index / 32] |= (1UL << (index % 32));
+            received_count++;
+            if (received_count == count) {
+                busy = false;
+                done = true;
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief
+         * function to check if the message in the buffer is complete
+         * @return boolean that's true after the last missing fragment of a message until a fragment of the next one
+         */
+        bool complete() const {
+            return done;
+        }
+
+        /**
+         * @brief
+         * function to get the message
+         * @return pointer to the buffer, only valid if complete() is true
+         */
+        const uint8_t *message() const {
+            return buffer.begin();
+        }
+
+        /**
+         * @brief
+         * function to get the length of the message
+         * @return size_t length of the message, only valid if complete() is true
+         */
+        size_t message_length() const {
+            return length;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of fragments of the current message that are not received yet
+         * @return size_t amount of missing fragments, 0 if there is no incomplete message
+         */
+        size_t missing() const {
+            return busy ? count - received_count : 0;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of fragments that were already received
+         * @return uint32_t amount of duplicate fragments
+         */
+        uint32_t duplicate_count() const {
+            return duplicates;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of fragments that were missing from dropped messages
+         * @return uint32_t amount of missing fragments
+         */
+        uint32_t gap_count() const {
+            return gaps;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of fragments that are not valid
+         * @return uint32_t amount of fragments that are not valid
+         */
+        uint32_t invalid_count() const {
+            return invalid;
+        }
+
+        /**
+         * @brief
+         * function to reset the counters
+         */
+        void reset_counters() {
+            duplicates = 0;
+            gaps = 0;
+            invalid = 0;
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_TRANSPORT_H
@@ -0,0 +1,580 @@
+#include "RF24L01_Sim.hpp"
+
+namespace IPASS {
+    RF24L01_Sim::RF24L01_Sim(RF24L01_Air &air) :
+            air(air),
+            sclk(*this, &RF24L01_Sim::write_sclk),
+            mosi(*this, &RF24L01_Sim::write_mosi),
+            miso(*this, &RF24L01_Sim::read_miso),
+            csn(*this, &RF24L01_Sim::write_csn),
+            ce(*this, &RF24L01_Sim::write_ce),
+            irq(*this, &RF24L01_Sim::read_irq),
+            bus(sclk, mosi, miso) {
+        power_on_reset();
+        air.attach(*this);
+    }
+
+    uint_fast64_t RF24L01_Sim::now() {
+        return hwlib::now_us();
+    }
+
+    void RF24L01_Sim::update() {
+        air.update();
+    }
+
+    void RF24L01_Sim::power_on_reset() {
+        registers = {};
+        registers[0x00] = 0x08;
+        registers[0x01] = 0x3F;
+        registers[0x02] = 0x03;
+        registers[0x03] = 0x03;
+        registers[0x04] = 0x03;
+        registers[0x05] = 0x02;
+        registers[0x06] = 0x0F;
+        registers[0x0C] = 0xC3;
+        registers[0x0D] = 0xC4;
+        registers[0x0E] = 0xC5;
+        registers[0x0F] = 0xC6;
+        addresses[0] = {0xE7, 0xE7, 0xE7, 0xE7, 0xE7};
+        addresses[1] = {0xC2, 0xC2, 0xC2, 0xC2, 0xC2};
+        addresses[2] = {0xE7, 0xE7, 0xE7, 0xE7, 0xE7};
+        flags = 0;
+        features_active = false;
+        tx_fifo.count = 0;
+        rx_fifo.count = 0;
+        listening = false;
+        carrier_seen = false;
+        tx_state = tx_states::idle;
+        arc_count = 0;
+        lost_count = 0;
+        last_sender = {};
+    }
+
+    uint8_t RF24L01_Sim::peek(uint8_t address) {
+        update();
+        return read_register(address, 0);
+    }
+
+    uint8_t RF24L01_Sim::status_register() const {
+        uint8_t pipe = rx_fifo.count > 0 ? rx_fifo.entries[0].pipe : 0x07;
+        return flags | (pipe << 1) | (tx_fifo.count == 3 ? 0x01 : 0x00);
+    }
+
+    uint8_t RF24L01_Sim::read_register(uint8_t address, size_t index) const {
+        switch (address) {
+            case 0x07:
+                return status_register();
+            case 0x08:
+                return (lost_count << 4) | arc_count;
+            case 0x09: {
+                bool settled = listening and hwlib::now_us() >= listening_since + 128;
+                bool carrier = carrier_seen or air.interference[registers[0x05]] > 0;
+                return (settled and carrier) ? 0x01 : 0x00;
+            }
+            case 0x0A:
+                return addresses[0][index % 5];
+            case 0x0B:
+                return addresses[1][index % 5];
+            case 0x10:
+                return addresses[2][index % 5];
+            case 0x17:
+                return (tx_fifo.count == 3 ? 0x20 : 0x00) | (tx_fifo.count == 0 ? 0x10 : 0x00) |
+                       (rx_fifo.count == 3 ? 0x02 : 0x00) | (rx_fifo.count == 0 ? 0x01 : 0x00);
+            default:
+                return address < registers.size() ? registers[address] : 0x00;
+        }
+    }
+
+    void RF24L01_Sim::write_register(uint8_t address, const uint8_t data[], size_t length) {
+        switch (address) {
+            case 0x07:
+                flags &= ~(data[0] & 0x70);
+                break;
+            case 0x08:
+            case 0x09:
+            case 0x17:
+                break;
+            case 0x0A:
+            case 0x0B:
+            case 0x10: {
+                std::array<uint8_t, 5> &target = addresses[address == 0x10 ? 2 : address - 0x0A];
+                for (size_t i = 0; i < length and i < 5; i++) {
+                    target[i] = data[i];
+                }
+                break;
+            }
+            case 0x05:
+                registers[0x05] = data[0] & 0x7F;
+                // writing RF_CH resets PLOS_CNT. The model also starts the 130 us settling again and clears CD, so a
+                // write with CE high is not better than on the RF24L01, which only allows a new channel in standby
+                lost_count = 0;
+                carrier_seen = false;
+                listening_since = now();
+                break;
+            case 0x1C:
+            case 0x1D:
+                if (features_active) {
+                    registers[address] = data[0];
+                }
+                break;
+            default:
+                if (address < registers.size()) {
+                    registers[address] = data[0];
+                }
+                break;
+        }
+        if (not powered()) {
+            tx_state = tx_states::idle;
+        }
+    }
+
+    uint8_t RF24L01_Sim::address_width() const {
+        uint8_t aw = registers[0x03] & 0x03;
+        return aw == 0 ? 5 : aw + 2;
+    }
+
+    const uint8_t *RF24L01_Sim::pipe_address(uint8_t pipe, std::array<uint8_t, 5> &buffer) const {
+        if (pipe < 2) {
+            return addresses[pipe].begin();
+        }
+        buffer = addresses[1];
+        buffer[0] = registers[0x0C + pipe - 2];
+        return buffer.begin();
+    }
+
+    bool RF24L01_Sim::powered() const {
+        return registers[0x00] & 0x02;
+    }
+
+    bool RF24L01_Sim::dynamic_payload(uint8_t pipe) const {
+        return (registers[0x1D] & 0x04) and (registers[0x1C] & (1 << pipe));
+    }
+
+    uint8_t RF24L01_Sim::crc_length() const {
+        // auto acknowledgement forces the CRC on
+        bool crc = (registers[0x00] & 0x08) or (registers[0x01] & 0x3F);
+        if (not crc) {
+            return 0;
+        }
+        return (registers[0x00] & 0x04) ? 2 : 1;
+    }
+
+    bool RF24L01_Sim::rate_2mbps() const {
+        return registers[0x06] & 0x08;
+    }
+
+    uint_fast64_t RF24L01_Sim::airtime(size_t payload_length) const {
+        // preamble, address, packet control field, payload and CRC
+        uint_fast64_t bits = 8 + address_width() * 8 + 9 + payload_length * 8 + crc_length() * 8;
+        return rate_2mbps() ? (bits + 1) / 2 : bits;
+    }
+
+    uint_fast64_t RF24L01_Sim::retransmit_delay() const {
+        return 250 * ((registers[0x04] >> 4) + 1);
+    }
+
+    void RF24L01_Sim::update_listening(uint_fast64_t time) {
+        bool listen = powered() and (registers[0x00] & 0x01) and ce_level;
+        if (listen and not listening) {
+            listening_since = time;
+            carrier_seen = false;
+        }
+        listening = listen;
+    }
+
+    int RF24L01_Sim::tx_front() const {
+        for (int i = 0; i < tx_fifo.count; i++) {
+            if (tx_fifo.entries[i].pipe == 0xFF) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void RF24L01_Sim::try_start(uint_fast64_t time) {
+        if (tx_state == tx_states::idle and powered() and not(registers[0x00] & 0x01) and ce_level and
+            not(flags & 0x10) and tx_front() >= 0) {
+            tx_state = tx_states::settling;
+            tx_event = time + 130;
+            arc_count = 0;
+            if (not reuse_pid) {
+                pid = (pid + 1) & 0x03;
+            }
+            reuse_pid = false;
+            ack_received = false;
+        }
+    }
+
+    bool RF24L01_Sim::has_event() const {
+        return tx_state != tx_states::idle;
+    }
+
+    void RF24L01_Sim::process_event(uint_fast64_t time) {
+        int front = tx_front();
+        if (front < 0) {
+            // the payload was flushed during the transmission
+            tx_state = tx_states::idle;
+            return;
+        }
+        const payload &packet = tx_fifo.entries[front];
+        switch (tx_state) {
+            case tx_states::settling:
+            case tx_states::wait_retransmit:
+                if (tx_state == tx_states::wait_retransmit) {
+                    if (arc_count >= (registers[0x04] & 0x0F)) {
+                        flags |= 0x10;
+                        reuse_pid = true;
+                        if (lost_count < 15) {
+                            lost_count++;
+                        }
+                        tx_state = tx_states::idle;
+                        return;
+                    }
+                    arc_count++;
+                }
+                tx_state = tx_states::on_air;
+                tx_start = time;
+                tx_channel = registers[0x05];
+                tx_end = time + airtime(packet.length);
+                tx_event = tx_end;
+                air.carrier(tx_channel);
+                break;
+            case tx_states::on_air: {
+                bool expects_ack = not packet.no_ack and (registers[0x01] & 0x01);
+                uint_fast64_t ack_time = time;
+                ack_payload.length = 0;
+                bool acked = air.transmit(*this, packet, pid, tx_start, time, ack_payload, ack_time);
+                if (not expects_ack) {
+                    tx_state = tx_states::wait_ack;
+                    tx_event = time;
+                    ack_payload.length = 0;
+                } else if (acked) {
+                    tx_state = tx_states::wait_ack;
+                    tx_event = ack_time;
+                } else {
+                    tx_state = tx_states::wait_retransmit;
+                    tx_event = time + retransmit_delay();
+                }
+                break;
+            }
+            case tx_states::wait_ack:
+                pop(tx_fifo, front);
+                flags |= 0x20;
+                if (ack_payload.length > 0 and rx_fifo.count < 3) {
+                    ack_payload.pipe = 0;
+                    push(rx_fifo, ack_payload);
+                    flags |= 0x40;
+                }
+                tx_state = tx_states::idle;
+                try_start(time);
+                break;
+            case tx_states::idle:
+                break;
+        }
+    }
+
+    void RF24L01_Sim::push(fifo &queue, const payload &entry) {
+        if (queue.count < 3) {
+            queue.entries[queue.count] = entry;
+            queue.count++;
+        }
+    }
+
+    void RF24L01_Sim::pop(fifo &queue, int index) {
+        for (int i = index; i + 1 < queue.count; i++) {
+            queue.entries[i] = queue.entries[i + 1];
+        }
+        queue.count--;
+    }
+
+    bool RF24L01_Sim::receive(const RF24L01_Sim &sender, const payload &packet, uint8_t packet_pid,
+                              uint_fast64_t start, bool &send_ack, payload &ack) {
+        send_ack = false;
+        if (not listening or start < listening_since + 130 or registers[0x05] != sender.tx_channel or
+            rate_2mbps() != sender.rate_2mbps() or crc_length() != sender.crc_length() or
+            address_width() != sender.address_width()) {
+            return false;
+        }
+        uint8_t width = address_width();
+        std::array<uint8_t, 5> buffer = {};
+        int pipe = -1;
+        for (uint8_t p = 0; p < 6 and pipe < 0; p++) {
+            if (not(registers[0x02] & (1 << p))) {
+                continue;
+            }
+            const uint8_t *address = pipe_address(p, buffer);
+            bool match = true;
+            for (uint8_t i = 0; i < width; i++) {
+                match = match and address[i] == sender.addresses[2][i];
+            }
+            if (match) {
+                pipe = p;
+            }
+        }
+        if (pipe < 0 or dynamic_payload(pipe) != sender.dynamic_payload(0)) {
+            return false;
+        }
+        if (not dynamic_payload(pipe) and packet.length != registers[0x11 + pipe]) {
+            // a different payload width ends in a CRC error
+            return false;
+        }
+        bool auto_ack = (registers[0x01] & (1 << pipe)) and not packet.no_ack;
+        bool duplicate = not packet.no_ack and last_sender[pipe] == &sender and last_pid[pipe] == packet_pid;
+        if (not duplicate) {
+            if (rx_fifo.count == 3) {
+                // no room in the RX FIFO, the packet is dropped and not acknowledged
+                return false;
+            }
+            payload entry = packet;
+            entry.pipe = pipe;
+            push(rx_fifo, entry);
+            flags |= 0x40;
+            last_sender[pipe] = &sender;
+            last_pid[pipe] = packet_pid;
+        }
+        if (auto_ack) {
+            send_ack = true;
+            if (features_active and (registers[0x1D] & 0x02)) {
+                for (int i = 0; i < tx_fifo.count; i++) {
+                    if (tx_fifo.entries[i].pipe == pipe) {
+                        ack = tx_fifo.entries[i];
+                        pop(tx_fifo, i);
+                        flags |= 0x20;
+                        break;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    uint8_t RF24L01_Sim::byte_received(uint8_t byte) {
+        size_t index = 0;
+        if (byte_index == 0) {
+            command = byte;
+        } else {
+            if (command_length < command_data.size()) {
+                command_data[command_length] = byte;
+                command_length++;
+            }
+            index = byte_index;
+        }
+        byte_index++;
+        if (command < 0x20) {
+            return read_register(command & 0x1F, index);
+        }
+        if (command == 0x61) {
+            return (rx_fifo.count > 0 and index < 32) ? rx_fifo.entries[0].data[index] : 0x00;
+        }
+        if (command == 0x60 and index == 0) {
+            return (features_active and rx_fifo.count > 0) ? rx_fifo.entries[0].length : 0x00;
+        }
+        return 0x00;
+    }
+
+    void RF24L01_Sim::transaction_end() {
+        uint_fast64_t time = now();
+        if (byte_index == 0) {
+            return;
+        }
+        if (command >= 0x20 and command < 0x40) {
+            if (command_length > 0) {
+                write_register(command & 0x1F, command_data.begin(), command_length);
+            }
+        } else if (command == 0x61) {
+            if (command_length > 0 and rx_fifo.count > 0) {
+                pop(rx_fifo, 0);
+            }
+        } else if (command == 0xA0 or command == 0xB0 or (command & 0xF8) == 0xA8) {
+            payload entry = {command_length, 0xFF, false, command_data};
+            bool allowed = command_length > 0;
+            if (command == 0xB0) {
+                entry.no_ack = true;
+                allowed = allowed and features_active and (registers[0x1D] & 0x01);
+            } else if (command != 0xA0) {
+                entry.pipe = command & 0x07;
+                allowed = allowed and entry.pipe < 6 and features_active and (registers[0x1D] & 0x02);
+            }
+            if (allowed) {
+                push(tx_fifo, entry);
+            }
+        } else if (command == 0xE1) {
+            tx_fifo.count = 0;
+            reuse_pid = false;
+        } else if (command == 0xE2) {
+            rx_fifo.count = 0;
+        } else if (command == 0x50) {
+            if (command_length > 0 and command_data[0] == 0x73) {
+                features_active = not features_active;
+            }
+        }
+        update_listening(time);
+        try_start(time);
+    }
+
+    void RF24L01_Sim::write_sclk(bool v) {
+        if (not csn_level) {
+            if (v and not sclk_level) {
+                shift_in = (shift_in << 1) | (mosi_level ? 1 : 0);
+                bit_count++;
+                if (bit_count == 8) {
+                    next_out = byte_received(shift_in);
+                }
+            } else if (not v and sclk_level) {
+                if (bit_count == 8) {
+                    shift_out = next_out;
+                    bit_count = 0;
+                    shift_in = 0;
+                } else {
+                    shift_out <<= 1;
+                }
+            }
+        }
+        sclk_level = v;
+    }
+
+    void RF24L01_Sim::write_mosi(bool v) {
+        mosi_level = v;
+    }
+
+    void RF24L01_Sim::write_csn(bool v) {
+        if (v == csn_level) {
+            return;
+        }
+        update();
+        csn_level = v;
+        if (not v) {
+            byte_index = 0;
+            bit_count = 0;
+            shift_in = 0;
+            command_length = 0;
+            shift_out = status_register();
+        } else {
+            transaction_end();
+        }
+    }
+
+    void RF24L01_Sim::write_ce(bool v) {
+        update();
+        ce_level = v;
+        update_listening(now());
+        try_start(now());
+    }
+
+    bool RF24L01_Sim::read_miso() {
+        return not csn_level and (shift_out & 0x80);
+    }
+
+    bool RF24L01_Sim::read_irq() {
+        update();
+        return not(flags & ~registers[0x00] & 0x70);
+    }
+
+    RF24L01_Air::RF24L01_Air(uint32_t seed) :
+            random_state(seed) {}
+
+    bool RF24L01_Air::random_loss(uint16_t per_mille) {
+        if (per_mille == 0) {
+            return false;
+        }
+        random_state = random_state * 1103515245 + 12345;
+        return ((random_state >> 16) % 1000) < per_mille;
+    }
+
+    void RF24L01_Air::attach(RF24L01_Sim &chip) {
+        if (chip_count < chips.size()) {
+            chips[chip_count] = &chip;
+            chip_count++;
+        }
+    }
+
+    void RF24L01_Air::update() {
+        if (updating) {
+            return;
+        }
+        updating = true;
+        uint_fast64_t time = hwlib::now_us();
+        for (;;) {
+            RF24L01_Sim *next = nullptr;
+            for (size_t i = 0; i < chip_count; i++) {
+                if (chips[i]->has_event() and chips[i]->tx_event <= time and
+                    (next == nullptr or chips[i]->tx_event < next->tx_event)) {
+                    next = chips[i];
+                }
+            }
+            if (next == nullptr) {
+                break;
+            }
+            next->process_event(next->tx_event);
+        }
+        updating = false;
+    }
+
+    void RF24L01_Air::carrier(uint8_t channel) {
+        for (size_t i = 0; i < chip_count; i++) {
+            if (chips[i]->listening and chips[i]->registers[0x05] == channel) {
+                chips[i]->carrier_seen = true;
+            }
+        }
+    }
+
+    bool RF24L01_Air::transmit(RF24L01_Sim &sender, const RF24L01_Sim::payload &packet, uint8_t packet_pid,
+                               uint_fast64_t start, uint_fast64_t end, RF24L01_Sim::payload &ack,
+                               uint_fast64_t &ack_time) {
+        sent++;
+        uint8_t channel = sender.tx_channel;
+        bool collision = false;
+        for (size_t i = 0; i < chip_count; i++) {
+            RF24L01_Sim &other = *chips[i];
+            if (&other != &sender and other.tx_channel == channel and other.tx_start < end and other.tx_end > start) {
+                collision = true;
+            }
+        }
+        if (collision or random_loss(loss) or random_loss(interference[channel])) {
+            lost++;
+            return false;
+        }
+        for (size_t i = 0; i < chip_count; i++) {
+            RF24L01_Sim &receiver = *chips[i];
+            bool send_ack = false;
+            if (&receiver == &sender or not receiver.receive(sender, packet, packet_pid, start, send_ack, ack)) {
+                continue;
+            }
+            if (not send_ack) {
+                return false;
+            }
+            // the acknowledgement is received on pipe 0, which needs the TX_ADDR of the sender
+            bool pipe_0_ok = sender.registers[0x02] & 0x01;
+            for (uint8_t b = 0; b < sender.address_width(); b++) {
+                pipe_0_ok = pipe_0_ok and sender.addresses[0][b] == sender.addresses[2][b];
+            }
+            sent++;
+            if (not pipe_0_ok or random_loss(loss) or random_loss(interference[channel])) {
+                lost++;
+                ack.length = 0;
+                return false;
+            }
+            ack_time = end + 130 + receiver.airtime(ack.length);
+            return true;
+        }
+        return false;
+    }
+
+    void RF24L01_Air::set_loss(uint16_t per_mille) {
+        loss = per_mille;
+    }
+
+    void RF24L01_Air::set_interference(uint8_t channel, uint16_t per_mille) {
+        if (channel < interference.size()) {
+            interference[channel] = per_mille;
+        }
+    }
+
+    uint32_t RF24L01_Air::packets_sent() const {
+        return sent;
+    }
+
+    uint32_t RF24L01_Air::packets_lost() const {
+        return lost;
+    }
+}
@@ -0,0 +1,468 @@
+//======================================================================================================================
+/**
+ *  @file      RF24L01_Sim.hpp
+ *  @brief     IPASS-project: Behavioral model of the RF24L01 and a virtual air medium to run the driver without radios.
+ */
+//======================================================================================================================
+#ifndef IPASS_RF24L01_SIM_H
+#define IPASS_RF24L01_SIM_H
+
+#ifndef HWLIB_INC_HPP
+#define HWLIB_INC_HPP
+
+#include "hwlib.hpp"
+
+#endif //HWLIB_INC_HPP
+
+namespace IPASS {
+
+    class RF24L01_Air;
+
+    /**
+     * @brief
+     * Behavioral model of the RF24L01
+     * @details
+     * The model has the register file, the SPI-command decoder, the 3 deep TX and RX FIFOs, Enhanced ShockBurst with
+     * auto acknowledgement, acknowledgement payloads and auto retransmit timing, and the CE- and IRQ-pins. The pins and
+     * the bit banged SPI-bus of the model are hwlib objects, so an unchanged IPASS::RF24L01 can be constructed on them:
+     * @code
+     * IPASS::RF24L01_Air air;
+     * IPASS::RF24L01_Sim radio(air);
+     * IPASS::RF24L01 chip(radio.bus, radio.ce, radio.csn, radio.irq, address, address, 0x11);
+     * @endcode
+     * All timing uses hwlib::now_us(), the model catches up with the time on every pin access. The model behaves like
+     * the RF24L01 without plus: COMMAND::ACTIVATE is needed for REGISTER::FEATURE, REGISTER::DYNPD and the feature
+     * commands.
+     */
+    class RF24L01_Sim {
+    public:
+        /**
+         * @brief
+         * hwlib::pin_out that passes every write to a function of the model
+         */
+        class sim_pin_out : public hwlib::pin_out {
+        private:
+            /**
+             * @brief
+             * model the pin belongs to
+             */
+            RF24L01_Sim &chip;
+            /**
+             * @brief
+             * function of the model that handles a write
+             */
+            void (RF24L01_Sim::*handler)(bool);
+        public:
+            /**
+             * @brief
+             * constructor for sim_pin_out
+             * @param chip model the pin belongs to
+             * @param handler function of the model that handles a write
+             */
+            sim_pin_out(RF24L01_Sim &chip, void (RF24L01_Sim::*handler)(bool)) :
+                    chip(chip), handler(handler) {}
+
+            void write(bool v) override {
+                (chip.*handler)(v);
+            }
+        };
+
+        /**
+         * @brief
+         * hwlib::pin_in that gets the level from a function of the model
+         */
+        class sim_pin_in : public hwlib::pin_in {
+        private:
+            /**
+             * @brief
+             * model the pin belongs to
+             */
+            RF24L01_Sim &chip;
+            /**
+             * @brief
+             * function of the model that returns the level
+             */
+            bool (RF24L01_Sim::*handler)();
+        public:
+            /**
+             * @brief
+             * constructor for sim_pin_in
+             * @param chip model the pin belongs to
+             * @param handler function of the model that returns the level
+             */
+            sim_pin_in(RF24L01_Sim &chip, bool (RF24L01_Sim::*handler)()) :
+                    chip(chip), handler(handler) {}
+
+            bool read() override {
+                return (chip.*handler)();
+            }
+        };
+
+    private:
+        /**
+         * @brief
+         * Struct payload for an entry of the TX or RX FIFO
+         */
+        struct payload {
+            ///amount of bytes in data
+            uint8_t length;
+            ///the pipe of an RX payload or of an acknowledgement payload, 0xFF for a normal TX payload
+            uint8_t pipe;
+            ///boolean that's true for a payload written with COMMAND::W_TX_PAYLOAD_NO_ACK
+            bool no_ack;
+            ///the payload, data[0] is the first byte send over the air
+            std::array<uint8_t, 32> data;
+        };
+
+        /**
+         * @brief
+         * Struct fifo with 3 payloads
+         */
+        struct fifo {
+            ///the payloads, index 0 is the front
+            std::array<payload, 3> entries;
+            ///amount of payloads in the fifo
+            uint8_t count;
+        };
+
+        /**
+         * @brief
+         * states of the transmitter
+         */
+        enum class tx_states {
+            idle, settling, on_air, wait_ack, wait_retransmit
+        };
+
+        /**
+         * @brief
+         * air medium the model is connected to
+         */
+        RF24L01_Air &air;
+
+        /**
+         * @brief
+         * single byte registers, indexed by register address
+         */
+        std::array<uint8_t, 0x1E> registers = {};
+        /**
+         * @brief
+         * the 5 byte registers RX_ADDR_P0, RX_ADDR_P1 and TX_ADDR, byte 0 is the least significant byte
+         */
+        std::array<std::array<uint8_t, 5>, 3> addresses = {};
+        /**
+         * @brief
+         * RX_DR, TX_DS and MAX_RT bits of the STATUS register
+         */
+        uint8_t flags = 0;
+        /**
+         * @brief
+         * boolean that indicates if COMMAND::ACTIVATE enabled the features
+         */
+        bool features_active = false;
+
+        /**
+         * @brief
+         * TX FIFO
+         */
+        fifo tx_fifo = {};
+        /**
+         * @brief
+         * RX FIFO
+         */
+        fifo rx_fifo = {};
+
+        ///level of the CSN-pin
+        bool csn_level = true;
+        ///level of the SCK-pin
+        bool sclk_level = false;
+        ///level of the MOSI-pin
+        bool mosi_level = false;
+        ///bits received on MOSI of the current byte
+        uint8_t shift_in = 0;
+        ///bits that are send on MISO, the most significant bit is on the pin
+        uint8_t shift_out = 0;
+        ///byte that's loaded into shift_out after the current byte
+        uint8_t next_out = 0;
+        ///amount of bits of the current byte
+        uint8_t bit_count = 0;
+        ///amount of bytes of the current transaction
+        size_t byte_index = 0;
+        ///the command byte of the current transaction
+        uint8_t command = 0;
+        ///the data bytes of the current transaction
+        std::array<uint8_t, 32> command_data = {};
+        ///amount of data bytes of the current transaction
+        uint8_t command_length = 0;
+
+        ///level of the CE-pin
+        bool ce_level = false;
+        ///boolean that's true in RX-mode with CE high
+        bool listening = false;
+        ///time in us the model started listening or changed channel
+        uint_fast64_t listening_since = 0;
+        ///boolean that's true if a carrier was seen on the channel since listening_since
+        bool carrier_seen = false;
+        ///state of the transmitter
+        tx_states tx_state = tx_states::idle;
+        ///time in us of the next state change of the transmitter
+        uint_fast64_t tx_event = 0;
+        ///start time in us of the last packet on air
+        uint_fast64_t tx_start = 0;
+        ///end time in us of the last packet on air
+        uint_fast64_t tx_end = 0;
+        ///channel of the last packet on air
+        uint8_t tx_channel = 0;
+        ///retransmits of the current payload, ARC_CNT of REGISTER::OBSERVE_TX
+        uint8_t arc_count = 0;
+        ///lost payloads since the last write to REGISTER::RF_CH, PLOS_CNT of REGISTER::OBSERVE_TX
+        uint8_t lost_count = 0;
+        ///packet identity of the current payload
+        uint8_t pid = 0;
+        ///boolean that's true if the front payload reached MAX_RT, a retry of it keeps its packet identity
+        bool reuse_pid = false;
+        ///boolean that's true if the current payload is acknowledged
+        bool ack_received = false;
+        ///acknowledgement payload of the current payload, length 0 if there is none
+        payload ack_payload = {};
+
+        ///sender of the last packet per pipe, for the duplicate detection of the receiver
+        std::array<const RF24L01_Sim *, 6> last_sender = {};
+        ///packet identity of the last packet per pipe, for the duplicate detection of the receiver
+        std::array<uint8_t, 6> last_pid = {};
+
+        friend class RF24L01_Air;
+
+        ///function to get the current time in us
+        uint_fast64_t now();
+        ///function to let the air medium process all events up to now
+        void update();
+        ///function to get the value of the STATUS register
+        uint8_t status_register() const;
+        ///function to get byte index of a register, index is only used by the 5 byte registers
+        uint8_t read_register(uint8_t address, size_t index) const;
+        ///function to write a register like COMMAND::W_REGISTER
+        void write_register(uint8_t address, const uint8_t data[], size_t length);
+        ///function to get the address width in bytes
+        uint8_t address_width() const;
+        ///function to get the address of a pipe, pipe 2-5 are build in buffer
+        const uint8_t *pipe_address(uint8_t pipe, std::array<uint8_t, 5> &buffer) const;
+        ///function to check if PWR_UP is set
+        bool powered() const;
+        ///function to check if a pipe uses dynamic payload length
+        bool dynamic_payload(uint8_t pipe) const;
+        ///function to get the effective CRC length in bytes
+        uint8_t crc_length() const;
+        ///function to check if the data rate is 2 Mbps
+        bool rate_2mbps() const;
+        ///function to get the time in us a packet with the payload length is on air
+        uint_fast64_t airtime(size_t payload_length) const;
+        ///function to get the auto retransmit delay in us
+        uint_fast64_t retransmit_delay() const;
+        ///function to update if the model listens after a change of CE or CONFIG
+        void update_listening(uint_fast64_t time);
+        ///function to start a transmission if the model is in TX-mode with CE high and a payload
+        void try_start(uint_fast64_t time);
+        ///function to handle the next state change of the transmitter
+        void process_event(uint_fast64_t time);
+        ///function to check if the transmitter has a pending state change
+        bool has_event() const;
+        ///function to get the index of the first normal TX payload, -1 if there is none
+        int tx_front() const;
+        ///function to add a payload to a fifo, the payload is dropped if the fifo is full
+        void push(fifo &queue, const payload &entry);
+        ///function to remove a payload from a fifo
+        void pop(fifo &queue, int index);
+        ///function to handle a byte received on MOSI, returns the next byte for MISO
+        uint8_t byte_received(uint8_t byte);
+        ///function to execute the command when CSN goes high
+        void transaction_end();
+        ///function called by the air medium for a packet on air, returns true if the model accepted the packet
+        bool receive(const RF24L01_Sim &sender, const payload &packet, uint8_t packet_pid, uint_fast64_t start,
+                     bool &send_ack, payload &ack);
+        ///handler of the SCK-pin
+        void write_sclk(bool v);
+        ///handler of the MOSI-pin
+        void write_mosi(bool v);
+        ///handler of the CSN-pin
+        void write_csn(bool v);
+        ///handler of the CE-pin
+        void write_ce(bool v);
+        ///handler of the MISO-pin
+        bool read_miso();
+        ///handler of the IRQ-pin
+        bool read_irq();
+
+    public:
+        /**
+         * @brief
+         * pin_out connected to the SCK-pin of the model
+         */
+        sim_pin_out sclk;
+        /**
+         * @brief
+         * pin_out connected to the MOSI-pin of the model
+         */
+        sim_pin_out mosi;
+        /**
+         * @brief
+         * pin_in connected to the MISO-pin of the model
+         */
+        sim_pin_in miso;
+        /**
+         * @brief
+         * pin_out connected to the CSN-pin of the model
+         */
+        sim_pin_out csn;
+        /**
+         * @brief
+         * pin_out connected to the CE-pin of the model
+         */
+        sim_pin_out ce;
+        /**
+         * @brief
+         * pin_in connected to the IRQ-pin of the model, active low
+         */
+        sim_pin_in irq;
+        /**
+         * @brief
+         * bit banged SPI-bus on sclk, mosi and miso
+         */
+        hwlib::spi_bus_bit_banged_sclk_mosi_miso bus;
+
+        /**
+         * @brief
+         * constructor for RF24L01_Sim
+         * @details
+         * The model starts with the reset values of the registers and connects itself to the air medium
+         * @param air air medium the model sends and receives on
+         */
+        explicit RF24L01_Sim(RF24L01_Air &air);
+
+        /**
+         * @brief
+         * function to reset the model to the power on state, like a brown-out of the chip
+         */
+        void power_on_reset();
+
+        /**
+         * @brief
+         * function to get a register without a SPI-transaction, for checks in tests
+         * @param address the address of a single byte register
+         * @return uint8_t value of the register
+         */
+        uint8_t peek(uint8_t address);
+    };
+
+    /**
+     * @brief
+     * Virtual air medium that connects RF24L01_Sim objects
+     * @details
+     * A payload that a model sends is delivered to every other model that listens on the same channel with the same
+     * data rate, CRC and address. Payloads can be lost by a fixed loss rate, by interference on a channel and by
+     * collisions of two models that send at the same time on the same channel. The losses use a seeded pseudo-random
+     * generator, so a simulation with hwlib::now_us() on a virtual clock gives the same result every run.
+     */
+    class RF24L01_Air {
+    private:
+        /**
+         * @brief
+         * the connected models
+         */
+        std::array<RF24L01_Sim *, 8> chips = {};
+        /**
+         * @brief
+         * amount of connected models
+         */
+        size_t chip_count = 0;
+        /**
+         * @brief
+         * chance in 1/1000 that a packet on a channel is lost by interference
+         */
+        std::array<uint16_t, 128> interference = {};
+        /**
+         * @brief
+         * chance in 1/1000 that any packet is lost
+         */
+        uint16_t loss = 0;
+        /**
+         * @brief
+         * state of the pseudo-random generator
+         */
+        uint32_t random_state;
+        /**
+         * @brief
+         * boolean that prevents recursion of update()
+         */
+        bool updating = false;
+        /**
+         * @brief
+         * amount of packets send, including retransmits and acknowledgements
+         */
+        uint32_t sent = 0;
+        /**
+         * @brief
+         * amount of packets lost by the loss rate, interference or collisions
+         */
+        uint32_t lost = 0;
+
+        friend class RF24L01_Sim;
+
+        ///function that returns true with a chance of per_mille in 1/1000
+        bool random_loss(uint16_t per_mille);
+        ///function to connect a model to the air medium
+        void attach(RF24L01_Sim &chip);
+        ///function to deliver a packet, returns true if the sender receives an acknowledgement
+        bool transmit(RF24L01_Sim &sender, const RF24L01_Sim::payload &packet, uint8_t packet_pid,
+                      uint_fast64_t start, uint_fast64_t end, RF24L01_Sim::payload &ack, uint_fast64_t &ack_time);
+        ///function to set the carrier detect of the models listening on a channel
+        void carrier(uint8_t channel);
+
+    public:
+        /**
+         * @brief
+         * constructor for RF24L01_Air
+         * @param seed seed of the pseudo-random generator for the losses
+         */
+        explicit RF24L01_Air(uint32_t seed = 1);
+
+        /**
+         * @brief
+         * function to process all events of the connected models up to hwlib::now_us()
+         * @details
+         * Called by the models on every pin access, call it when time passes without pin accesses
+         */
+        void update();
+
+        /**
+         * @brief
+         * function to set the chance that any packet is lost
+         * @param per_mille chance in 1/1000
+         */
+        void set_loss(uint16_t per_mille);
+
+        /**
+         * @brief
+         * function to set interference on a channel
+         * @details
+         * Packets on the channel are lost with the given chance and the carrier detect of a listening model is set
+         * @param channel the channel 0-127
+         * @param per_mille chance in 1/1000 that a packet on the channel is lost, 0 removes the interference
+         */
+        void set_interference(uint8_t channel, uint16_t per_mille);
+
+        /**
+         * @brief
+         * function to get the amount of packets send over the air, including retransmits and acknowledgements
+         * @return uint32_t amount of packets
+         */
+        uint32_t packets_sent() const;
+
+        /**
+         * @brief
+         * function to get the amount of packets lost over the air
+         * @return uint32_t amount of packets
+         */
+        uint32_t packets_lost() const;
+    };
+} //namespace IPASS
+#endif //IPASS_RF24L01_SIM_H
@@ -0,0 +1,151 @@
+//======================================================================================================================
+/**
+ *  @file      Ring_Buffer.hpp
+ *  @brief     IPASS-project: Lock-free single-producer/single-consumer ring buffer.
+ */
+//======================================================================================================================
+#ifndef IPASS_RING_BUFFER_H
+#define IPASS_RING_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * Fixed capacity single-producer/single-consumer ring buffer
+     * @details
+     * The producer (for example an interrupt handler) only changes head and the consumer (the main loop) only changes
+     * tail, so one producer and one consumer can use the buffer at the same time without locks or heap allocation.
+     * The producer can fill an element in place with producer_slot() and commit(), which avoids a copy of the element.
+     * @tparam T type of the elements
+     * @tparam capacity maximum amount of elements in the buffer, must be a power of 2
+     */
+    template<typename T, size_t capacity>
+    class Ring_Buffer {
+        static_assert(capacity > 0 and (capacity & (capacity - 1)) == 0, "capacity of Ring_Buffer must be a power of 2");
+    private:
+        /**
+         * @brief
+         * storage for the elements
+         */
+        std::array<T, capacity> elements = {};
+        /**
+         * @brief
+         * free running counter of the elements that are pushed, only written by the producer
+         */
+        std::atomic<size_t> head{0};
+        /**
+         * @brief
+         * free running counter of the elements that are popped, only written by the consumer
+         */
+        std::atomic<size_t> tail{0};
+
+    public:
+        /**
+         * @brief
+         * Producer: function to get the free element at the head of the buffer
+         * @details
+         * The element is not visible to the consumer until commit() is called
+         * @return pointer to the free element or nullptr if the buffer is full
+         */
+        T *producer_slot() {
+            size_t current_head = head.load(std::memory_order_relaxed);
+            if (current_head - tail.load(std::memory_order_acquire) == capacity) {
+                return nullptr;
+            }
+            return &elements[current_head % capacity];
+        }
+
+        /**
+         * @brief
+         * Producer: function to publish the element returned by producer_slot() to the consumer
+         */
+        void commit() {
+            head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief
+         * Producer: function to copy an element into the buffer
+         * @param element element to push
+         * @return returns false if the buffer is full and the element is not pushed
+         */
+        bool push(const T &element) {
+            T *slot = producer_slot();
+            if (slot == nullptr) {
+                return false;
+            }
+            *slot = element;
+            commit();
+            return true;
+        }
+
+        /**
+         * @brief
+         * Consumer: function to get the oldest element without removing it
+         * @return pointer to the oldest element or nullptr if the buffer is empty
+         */
+        const T *front() const {
+            size_t current_tail = tail.load(std::memory_order_relaxed);
+            if (head.load(std::memory_order_acquire) == current_tail) {
+                return nullptr;
+            }
+            return &elements[current_tail % capacity];
+        }
+
+        /**
+         * @brief
+         * Consumer: function to remove the element returned by front()
+         */
+        void pop_front() {
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief
+         * Consumer: function to copy and remove the oldest element
+         * @param element_out the oldest element is stored in this parameter
+         * @return returns false if the buffer is empty
+         */
+        bool pop(T &element_out) {
+            const T *oldest = front();
+            if (oldest == nullptr) {
+                return false;
+            }
+            element_out = *oldest;
+            pop_front();
+            return true;
+        }
+
+        /**
+         * @brief
+         * function to get the amount of elements in the buffer
+         * @return size_t amount of elements
+         */
+        size_t size() const {
+            return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief
+         * function to check if the buffer is empty
+         * @return returns true if there are no elements in the buffer
+         */
+        bool empty() const {
+            return size() == 0;
+        }
+
+        /**
+         * @brief
+         * function to check if the buffer is full
+         * @return returns true if there are capacity elements in the buffer
+         */
+        bool full() const {
+            return size() == capacity;
+        }
+    };
+} //namespace IPASS
+#endif //IPASS_RING_BUFFER_H
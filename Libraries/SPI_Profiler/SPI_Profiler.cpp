@@ -0,0 +1,107 @@
+#include "SPI_Profiler.hpp"
+#include <cstring>
+
+namespace IPASS {
+    SPI_Profiler::scope::scope(SPI_Profiler &profiler, const char *label) :
+            profiler(profiler), previous(profiler.current) {
+        profiler.current = profiler.find(label);
+        profiler.entries[profiler.current].calls++;
+    }
+
+    SPI_Profiler::scope::~scope() {
+        profiler.current = previous;
+    }
+
+    SPI_Profiler::SPI_Profiler(hwlib::spi_bus &bus, hwlib::pin_out &chip_select) :
+            bus(bus), select(*this, chip_select) {
+        entries[0].label = "other";
+    }
+
+    SPI_Profiler::entry &SPI_Profiler::current_entry() {
+        return entries[current];
+    }
+
+    size_t SPI_Profiler::find(const char *label) {
+        for (size_t i = 0; i < max_labels; i++) {
+            if (entries[i].label == nullptr) {
+                entries[i].label = label;
+                return i;
+            }
+            if (entries[i].label == label or std::strcmp(entries[i].label, label) == 0) {
+                return i;
+            }
+        }
+        // the table is full, the extra entry after it collects the other labels
+        entries[max_labels].label = "(overflow)";
+        return max_labels;
+    }
+
+    void SPI_Profiler::write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]) {
+        entry &counts = current_entry();
+        if (not selected) {
+            counts.transactions++;
+        }
+        counts.bytes += n;
+        uint_fast64_t start = hwlib::now_ticks();
+        {
+            // the real chip select is driven by select, so the real bus gets a dummy
+            auto transaction = bus.transaction(hwlib::pin_out_dummy);
+            transaction.write_and_read(n, data_out, data_in);
+        }
+        counts.ticks += hwlib::now_ticks() - start;
+    }
+
+    [[maybe_unused]] SPI_Profiler::entry SPI_Profiler::get(const char *label) const {
+        for (const entry &counts : entries) {
+            if (counts.label != nullptr and std::strcmp(counts.label, label) == 0) {
+                return counts;
+            }
+        }
+        return {label, 0, 0, 0, 0};
+    }
+
+    [[maybe_unused]] void SPI_Profiler::print(hwlib::ostream &out) const {
+        out << "label                      calls   trans   bytes   bus_us\n";
+        for (const entry &counts : entries) {
+            if (counts.label == nullptr) {
+                continue;
+            }
+            out << counts.label;
+            for (size_t i = std::strlen(counts.label); i < 24; i++) {
+                out << ' ';
+            }
+            for (uint_fast64_t value : {uint_fast64_t(counts.calls), uint_fast64_t(counts.transactions),
+                                        uint_fast64_t(counts.bytes), counts.ticks / hwlib::ticks_per_us()}) {
+                uint_fast64_t digits = 1;
+                for (uint_fast64_t rest = value; rest >= 10; rest /= 10) {
+                    digits++;
+                }
+                for (; digits < 8; digits++) {
+                    out << ' ';
+                }
+                out << value;
+            }
+            out << '\n';
+        }
+    }
+
+    [[maybe_unused]] void SPI_Profiler::print_csv(hwlib::ostream &out) const {
+        out << "label,calls,transactions,bytes,bus_ns\n";
+        for (const entry &counts : entries) {
+            if (counts.label == nullptr) {
+                continue;
+            }
+            out << counts.label << ',' << counts.calls << ',' << counts.transactions << ',' << counts.bytes << ','
+                << counts.ticks * 1000 / hwlib::ticks_per_us() << '\n';
+        }
+    }
+
+    [[maybe_unused]] void SPI_Profiler::reset() {
+        for (entry &counts : entries) {
+            counts.calls = 0;
+            counts.transactions = 0;
+            counts.bytes = 0;
+            counts.ticks = 0;
+        }
+    }
+}
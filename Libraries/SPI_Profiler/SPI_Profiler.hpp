@@ -0,0 +1,222 @@
+//======================================================================================================================
+/**
+ *  @file      SPI_Profiler.hpp
+ *  @brief     IPASS-project: SPI-bus decorator that counts transactions, bytes and bus time per labeled scope.
+ */
+//======================================================================================================================
+#ifndef IPASS_SPI_PROFILER_H
+#define IPASS_SPI_PROFILER_H
+
+#ifndef HWLIB_INC_HPP
+#define HWLIB_INC_HPP
+
+#include "hwlib.hpp"
+
+#endif //HWLIB_INC_HPP
+
+namespace IPASS {
+
+    /**
+     * @brief
+     * SPI-bus decorator that measures the bus traffic of the drivers
+     * @details
+     * The profiler is passed to a driver instead of the real bus and passes every byte on to the real bus. It counts
+     * the transactions, the bytes and the bus time in ticks of hwlib::now_ticks(), which is the virtual clock on the host.
+     * The counts go to the label of the innermost open scope, so the cost of every call of the driver is visible:
+     * @code
+     * IPASS::SPI_Profiler profiler(spi_bus, minion_select);
+     * IPASS::RF24L01 chip(profiler, CE, profiler.select, IRQ, address, address);
+     * {
+     *     IPASS::SPI_Profiler::scope measure(profiler, "write_tx");
+     *     chip.write_tx(data);
+     * }
+     * profiler.print();
+     * @endcode
+     * A transaction is counted on every falling edge of select. A driver that doesn't use select, like the APA102,
+     * gets one transaction per write to the bus. Traffic outside all scopes goes to the label "other".
+     */
+    class SPI_Profiler : public hwlib::spi_bus {
+    public:
+        /**
+         * @brief
+         * maximum amount of labels, the labels that don't fit go to the extra label "(overflow)"
+         */
+        static constexpr size_t max_labels = 24;
+
+        /**
+         * @brief
+         * Struct entry with the counts of one label
+         */
+        struct entry {
+            ///the label, nullptr if the entry is not used
+            const char *label;
+            ///amount of times a scope with the label was opened
+            uint32_t calls;
+            ///amount of SPI-transactions
+            uint32_t transactions;
+            ///amount of bytes clocked over the bus
+            uint32_t bytes;
+            ///bus time in ticks of hwlib::now_ticks()
+            uint_fast64_t ticks;
+        };
+
+        /**
+         * @brief
+         * chip select pin of the profiler, passes every write to the real chip select pin and counts the transactions
+         */
+        class select_pin : public hwlib::pin_out {
+        private:
+            /**
+             * @brief
+             * profiler the pin belongs to
+             */
+            SPI_Profiler &profiler;
+            /**
+             * @brief
+             * the real chip select pin
+             */
+            hwlib::pin_out &pin;
+        public:
+            /**
+             * @brief
+             * constructor for select_pin
+             * @param profiler profiler the pin belongs to
+             * @param pin the real chip select pin
+             */
+            select_pin(SPI_Profiler &profiler, hwlib::pin_out &pin) :
+                    profiler(profiler), pin(pin) {}
+
+            void write(bool v) override {
+                if (not v and not profiler.selected) {
+                    profiler.current_entry().transactions++;
+                }
+                profiler.selected = not v;
+                pin.write(v);
+            }
+
+            void flush() override {
+                pin.flush();
+            }
+        };
+
+        /**
+         * @brief
+         * RAII-object that sends all traffic during its lifetime to a label
+         */
+        class scope {
+        private:
+            /**
+             * @brief
+             * profiler the scope belongs to
+             */
+            SPI_Profiler &profiler;
+            /**
+             * @brief
+             * index of the label of the enclosing scope
+             */
+            size_t previous;
+        public:
+            /**
+             * @brief
+             * constructor for scope, opens the scope
+             * @param profiler profiler the scope belongs to
+             * @param label the label, the pointer is stored so it must stay valid, like a string literal
+             */
+            scope(SPI_Profiler &profiler, const char *label);
+
+            scope(const scope &) = delete;
+
+            /**
+             * @brief
+             * destructor for scope, the enclosing scope gets the traffic again
+             */
+            ~scope();
+        };
+
+    private:
+        /**
+         * @brief
+         * the real bus
+         */
+        hwlib::spi_bus &bus;
+        /**
+         * @brief
+         * the counts per label, entry 0 is "other" and entry max_labels is "(overflow)" once a label didn't fit
+         */
+        std::array<entry, max_labels + 1> entries = {};
+        /**
+         * @brief
+         * index of the label of the innermost open scope
+         */
+        size_t current = 0;
+        /**
+         * @brief
+         * boolean that's true while select is low
+         */
+        bool selected = false;
+
+        /**
+         * @brief
+         * function to get the entry of the innermost open scope
+         * @return entry& the entry
+         */
+        entry &current_entry();
+
+        /**
+         * @brief
+         * function to get the index of the entry of a label, a new entry is made for a new label
+         * @param label the label
+         * @return size_t the index
+         */
+        size_t find(const char *label);
+
+    protected:
+        void write_and_read(const size_t n, const uint8_t data_out[], uint8_t data_in[]) override;
+
+    public:
+        /**
+         * @brief
+         * chip select pin to pass to the driver, passes every write to the pin given to the constructor
+         */
+        select_pin select;
+
+        /**
+         * @brief
+         * constructor for SPI_Profiler
+         * @param bus the real bus
+         * @param chip_select the real chip select pin of the driver, can be left out if the driver doesn't use one
+         */
+        explicit SPI_Profiler(hwlib::spi_bus &bus, hwlib::pin_out &chip_select = hwlib::pin_out_dummy);
+
+        /**
+         * @brief
+         * function to get the counts of a label
+         * @param label the label, compared by content
+         * @return entry the counts, all 0 if the label is not known
+         */
+        [[maybe_unused]] entry get(const char *label) const;
+
+        /**
+         * @brief
+         * function to print a table with the counts of all labels
+         * @param out the stream to print to
+         */
+        [[maybe_unused]] void print(hwlib::ostream &out = hwlib::cout) const;
+
+        /**
+         * @brief
+         * function to print the counts of all labels as CSV with a header line
+         * @details
+         * The columns are label, calls, transactions, bytes and bus_ns, so the report can be compared between builds
+         * @param out the stream to print to
+         */
+        [[maybe_unused]] void print_csv(hwlib::ostream &out = hwlib::cout) const;
+
+        /**
+         * @brief
+         * function to set all counts to 0
+         */
+        [[maybe_unused]] void reset();
+    };
+} //namespace IPASS
+#endif //IPASS_SPI_PROFILER_H
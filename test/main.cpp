@@ -1,4 +1,5 @@
 #include "../Libraries/RF24L01/RF24L01.hpp"
+#include "../Libraries/RF24L01/RF24L01_Scanner.hpp"
 
 int main() {
     //Kill the watchdog
@@ -19,9 +20,15 @@ int main() {
     IPASS::RF24L01 chip(spi_bus, RX_TX, minion_select, address, address, 0x11);
 
     //Set datarate to 1Mbps
-    chip.setting_disable(IPASS::RF24L01::SETTING::RF_DR);
+    chip.setting_disable<IPASS::RF24L01::SETTING::RF_DR>();
     hwlib::wait_ms(100);
 
-    hwlib::cout << "CD: " << chip.register_read(IPASS::RF24L01::REGISTER::CD);
+    //Survey the band and print the quietest channels
+    IPASS::RF24L01_Scanner scanner(chip);
+    scanner.scan(20);
+    scanner.print();
+    for (uint8_t channel : scanner.quietest<3>()) {
+        hwlib::cout << "quiet: " << channel << '\n';
+    }
     hwlib::cout << '\n'<< chip.test() << '\n';
 }
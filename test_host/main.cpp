@@ -0,0 +1,1447 @@
+#include "../Libraries/APA102/APA102.hpp"
+#include "../Libraries/Coroutine/Coroutine.hpp"
+#include "../Libraries/Deadline_Scheduler/Deadline_Scheduler.hpp"
+#include "../Libraries/HC_SR04/HC_SR04.hpp"
+#include "../Libraries/Latency_Histogram/Latency_Histogram.hpp"
+#include "../Libraries/RF24L01/RF24L01.hpp"
+#include "../Libraries/RF24L01/RF24L01_Ack_Channel.hpp"
+#include "../Libraries/RF24L01/RF24L01_Async_TX.hpp"
+#include "../Libraries/RF24L01/RF24L01_Config.hpp"
+#include "../Libraries/RF24L01/RF24L01_Coroutine.hpp"
+#include "../Libraries/RF24L01/RF24L01_Demux.hpp"
+#include "../Libraries/RF24L01/RF24L01_Hopper.hpp"
+#include "../Libraries/RF24L01/RF24L01_RX_Engine.hpp"
+#include "../Libraries/RF24L01/RF24L01_Scanner.hpp"
+#include "../Libraries/RF24L01/RF24L01_Timestamp.hpp"
+#include "../Libraries/RF24L01/RF24L01_Transport.hpp"
+#include "../Libraries/RF24L01_Sim/RF24L01_Sim.hpp"
+#include "../Libraries/SPI_Profiler/SPI_Profiler.hpp"
+#include <chrono>
+
+//amount of failed checks
+static int failures = 0;
+
+//print the result of a check and count the failures
+static void check(bool ok, const char *name) {
+    hwlib::cout << (ok ? "ok    " : "FAIL  ") << name << '\n';
+    if (not ok) {
+        failures++;
+    }
+}
+
+static void test_clock() {
+    hwlib::host::reset_clock();
+    hwlib::wait_us(10);
+    hwlib::wait_ms(2);
+    hwlib::wait_ns(500);
+    check(hwlib::host::clock_ns == 2'010'500, "virtual clock follows the wait functions");
+    check(hwlib::now_us() == 2010, "now_us() returns the virtual time");
+}
+
+static void test_APA102() {
+    hwlib::host::spi_bus_recorder<64> bus;
+    IPASS::APA102 leds(bus, 8);
+    hwlib::host::reset_clock();
+    leds.write(IPASS::APA102::yellow, 0xff);
+    bool frame_ok = bus.size() == 40 and bus[0] == 0x00 and bus[3] == 0x00 and bus[36] == 0xff and bus[39] == 0xff;
+    for (size_t led = 0; led < 8; led++) {
+        size_t index = 4 + led * 4;
+        frame_ok = frame_ok and bus[index] == 0xff and bus[index + 1] == 0x00 and bus[index + 2] == 0xff and
+                   bus[index + 3] == 0xff;
+    }
+    check(frame_ok, "APA102 start frame, 8 LED frames and end frame");
+    check(bus.call_count() == 1, "APA102 writes the strip in one call of the bus");
+    hwlib::cout << "      APA102 write of 8 LEDs: " << hwlib::now_us() << " us\n";
+
+    bus.clear();
+    std::array<std::array<uint8_t, 3>, 2> colors = {{{0x10, 0x20, 0x30}, {0x40, 0x50, 0x60}}};
+    leds.write(colors);
+    check(bus.size() == 16 and bus[4] == 0xe3 and bus[5] == 0x30 and bus[7] == 0x10 and bus[11] == 0x40 and
+          bus[12] == 0xff and bus[15] == 0xff, "APA102 write of an array of colors");
+}
+
+static void test_HC_SR04() {
+    hwlib::host::pin_out_recorder<8> trigger;
+    hwlib::host::pin_in_replay<4> echo;
+    IPASS::HC_SR04 sensor(trigger, echo);
+    hwlib::host::reset_clock();
+    //echo of an object at 1 meter: 2 * 1 / 343 s
+    echo.pulse(200'000, 5'831'000);
+    float distance = sensor.get_distance();
+    check(trigger.size() == 2 and trigger[0].level and not trigger[1].level and
+          trigger[1].time_ns - trigger[0].time_ns >= 10'000, "HC_SR04 trigger pulse of 10 us");
+    check(distance > 0.99f and distance < 1.01f, "HC_SR04 distance of an echo of 1 meter");
+}
+
+//the settings are constexpr values, so they can be checked at compile time
+static_assert(IPASS::RF24L01::SETTING::PWR_UP.REGISTER_ADDR == IPASS::RF24L01::REGISTER::CONFIG and
+              IPASS::RF24L01::SETTING::PWR_UP.Mask == 0x02, "SETTING::PWR_UP is bit 1 of CONFIG");
+static_assert(sizeof(IPASS::RF24L01::SETTING::Setting) == 3, "SETTING::Setting holds its values");
+
+static void test_RF24L01() {
+    IPASS::RF24L01_Air air;
+    IPASS::RF24L01_Sim radio_tx(air);
+    IPASS::RF24L01_Sim radio_rx(air);
+    const std::array<uint8_t, 5> address = {0xe7, 0xe7, 0xe7, 0xe7, 0xe7};
+    IPASS::RF24L01 chip_tx(radio_tx.bus, radio_tx.ce, radio_tx.csn, radio_tx.irq, address, address, 0x11, false);
+    IPASS::RF24L01 chip_rx(radio_rx.bus, radio_rx.ce, radio_rx.csn, radio_rx.irq, address, address, 0x11, false);
+    chip_tx.change_RX_PW_P(0, 5);
+    chip_rx.change_RX_PW_P(0, 5);
+    check(radio_tx.peek(IPASS::RF24L01::REGISTER::RF_CH) == 0x11, "RF24L01 constructor configures the channel");
+
+    chip_rx.start_RX();
+    hwlib::wait_us(200);
+    std::array<uint8_t, 5> data = {1, 2, 3, 4, 5};
+    uint_fast64_t start = hwlib::now_us();
+    chip_tx.write_tx(data);
+    hwlib::cout << "      RF24L01 write_tx of 5 bytes: " << hwlib::now_us() - start << " us\n";
+    chip_tx.send_packages();
+    hwlib::wait_ms(1);
+    check(chip_tx.last_status(IPASS::RF24L01::SETTING::TX_DS) or
+          (chip_tx.update_status() & IPASS::RF24L01::SETTING::TX_DS.Mask), "RF24L01 payload is acknowledged");
+    std::array<uint8_t, 5> received = {};
+    check(chip_rx.packet_received(), "RF24L01 payload is received");
+    chip_rx.read_rx(received);
+    check(received == data, "RF24L01 received payload equals the send payload");
+}
+
+//The RX engine keeps the packets of bursts that are larger than the 3 deep RX FIFO of the RF24L01
+static void test_RX_engine() {
+    IPASS::RF24L01_Air air;
+    IPASS::RF24L01_Sim radio_tx(air);
+    IPASS::RF24L01_Sim radio_rx(air);
+    const std::array<uint8_t, 5> address = {0xe7, 0xe7, 0xe7, 0xe7, 0xe7};
+    IPASS::RF24L01 chip_tx(radio_tx.bus, radio_tx.ce, radio_tx.csn, radio_tx.irq, address, address, 0x11, false);
+    IPASS::RF24L01 chip_rx(radio_rx.bus, radio_rx.ce, radio_rx.csn, radio_rx.irq, address, address, 0x11, false);
+    chip_tx.change_RX_PW_P(0, 5);
+    chip_rx.change_RX_PW_P(0, 5);
+    chip_rx.start_RX();
+    hwlib::wait_us(200);
+    IPASS::RF24L01_RX_Engine<5, 8> engine(chip_rx);
+
+    //burst of the ring capacity, the engine runs when the IRQ-pin is low like an interrupt handler would
+    auto burst = [&](uint8_t amount) {
+        for (uint8_t i = 0; i < amount; i++) {
+            std::array<uint8_t, 5> data = {i, 0, 0, 0, 0};
+            chip_tx.write_tx(data);
+            chip_tx.send_packages();
+            for (int t = 0; t < 40; t++) {
+                hwlib::wait_us(25);
+                engine.poll();
+            }
+        }
+    };
+    burst(8);
+    check(engine.available() == 8 and engine.overflow_count() == 0, "RX engine burst up to the ring capacity, no loss");
+    bool in_order = true;
+    IPASS::RF24L01_RX_Engine<5, 8>::packet packet = {};
+    for (uint8_t i = 0; i < 8; i++) {
+        in_order = in_order and engine.pop(packet) and packet.data[0] == i and packet.pipe == 0;
+    }
+    check(in_order, "RX engine keeps the order of the packets");
+
+    burst(12);
+    check(engine.available() == 8 and engine.overflow_count() == 4, "RX engine counts the packets above capacity");
+}
+
+//SPI-cost of the public calls of the RF24L01, printed as a table and as CSV
+static void test_SPI_Profiler() {
+    IPASS::RF24L01_Air air;
+    IPASS::RF24L01_Sim radio(air);
+    IPASS::SPI_Profiler profiler(radio.bus, radio.csn);
+    const std::array<uint8_t, 5> address = {0xe7, 0xe7, 0xe7, 0xe7, 0xe7};
+    IPASS::RF24L01 chip(profiler, radio.ce, profiler.select, radio.irq, address, address, 0x11, false);
+    std::array<uint8_t, 5> data = {1, 2, 3, 4, 5};
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "register_read(STATUS)");
+        chip.register_read(IPASS::RF24L01::REGISTER::STATUS);
+    }
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "setting_enable");
+        chip.setting_enable<IPASS::RF24L01::SETTING::PWR_UP>();
+    }
+    chip.use_shadow_registers();
+    chip.register_read(IPASS::RF24L01::REGISTER::CONFIG);
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "setting_enable shadow");
+        chip.setting_enable<IPASS::RF24L01::SETTING::PWR_UP>();
+    }
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "write_tx");
+        chip.write_tx(data);
+    }
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "write_tx no_ack");
+        chip.write_tx(data, true);
+    }
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "flush_rx_tx");
+        chip.flush_rx_tx();
+    }
+    check(profiler.get("register_read(STATUS)").transactions == 1 and
+          profiler.get("register_read(STATUS)").bytes == 1, "SPI_Profiler counts a NOP for the STATUS register");
+    check(profiler.get("setting_enable").transactions == 2 and profiler.get("setting_enable shadow").transactions == 1,
+          "SPI_Profiler shows the read saved by the shadow registers");
+    check(profiler.get("write_tx").bytes == 6, "SPI_Profiler counts the bytes of write_tx");
+    check(profiler.get("other").transactions > 0, "SPI_Profiler counts the constructor as other");
+    profiler.print();
+    profiler.print_csv();
+
+    //fill the table, the labels after it go to "(overflow)" and every label in the table keeps its counts
+    IPASS::SPI_Profiler full(radio.bus, radio.csn);
+    static char labels[IPASS::SPI_Profiler::max_labels + 1][4] = {};
+    for (size_t i = 1; i <= IPASS::SPI_Profiler::max_labels; i++) {
+        labels[i][0] = 'l';
+        labels[i][1] = char('0' + i / 10);
+        labels[i][2] = char('0' + i % 10);
+        IPASS::SPI_Profiler::scope measure(full, labels[i]);
+        uint8_t byte = 0xFF;
+        full.transaction(full.select).write_and_read(1, &byte, nullptr);
+    }
+    const char *last = labels[IPASS::SPI_Profiler::max_labels - 1];
+    check(full.get(last).calls == 1 and full.get(last).bytes == 1 and full.get("(overflow)").calls == 1 and
+          full.get("(overflow)").bytes == 1, "SPI_Profiler keeps the last label and counts the rest as (overflow)");
+}
+
+//configuration of the TX and RX example at 1 Mbps with a payload width of 5 on pipe 0
+static constexpr IPASS::RF24L01_Config example_config = IPASS::RF24L01_Config()
+        .channel(0x11)
+        .data_rate_2mbps(false)
+        .pipe(0, true, 5)
+        .pipe(1, false, 0);
+static constexpr IPASS::RF24L01_Config dynamic_config = example_config.dynamic_payloads(0x01).features(true, true);
+static_assert(example_config.rf_ch == 0x11 and example_config.rf_setup == 0x07 and example_config.rx_pw[0] == 5,
+              "the configuration image is computed at compile time");
+static_assert(not IPASS::RF24L01_Config().crc(false).valid() and not IPASS::RF24L01_Config().retries(16, 3).valid() and
+              not IPASS::RF24L01_Config().features(true, false).valid() and
+              not IPASS::RF24L01_Config().pipe(6, true, 5).valid() and
+              not IPASS::RF24L01_Config().rx_address(6, {}).valid(), "invalid configurations are detected");
+static_assert(IPASS::RF24L01_Config().pipe(6, true, 5).en_rxaddr == IPASS::RF24L01_Config().en_rxaddr and
+              IPASS::RF24L01_Config().pipe(6, false, 5, false).en_aa == IPASS::RF24L01_Config().en_aa,
+              "a pipe above 5 leaves EN_RXADDR and EN_AA unchanged");
+
+//two RF24L01_Sim on one air with their drivers, every SPI-transaction goes through a SPI_Profiler: the transmitter is
+//configured with tx_config, the receiver with rx_config and in RX-mode after its 130 us settling
+template<const IPASS::RF24L01_Config &tx_config = example_config, const IPASS::RF24L01_Config &rx_config = tx_config>
+struct sim_link {
+    IPASS::RF24L01_Air air;
+    IPASS::RF24L01_Sim radio_tx{air};
+    IPASS::RF24L01_Sim radio_rx{air};
+    IPASS::SPI_Profiler profiler_tx{radio_tx.bus, radio_tx.csn};
+    IPASS::SPI_Profiler profiler_rx{radio_rx.bus, radio_rx.csn};
+    IPASS::RF24L01 chip_tx{profiler_tx, radio_tx.ce, profiler_tx.select, radio_tx.irq};
+    IPASS::RF24L01 chip_rx{profiler_rx, radio_rx.ce, profiler_rx.select, radio_rx.irq};
+
+    sim_link() {
+        chip_tx.apply<tx_config>();
+        chip_rx.apply<rx_config>();
+        chip_rx.start_RX();
+        hwlib::wait_us(200);
+    }
+};
+
+//configurations that must not compile, the makefile compiles every block alone and checks the message of apply<>()
+#if defined(IPASS_COMPILE_FAIL_PIPE_NUMBER)
+static constexpr IPASS::RF24L01_Config compile_fail_config = IPASS::RF24L01_Config().pipe(7, true, 5);
+#elif defined(IPASS_COMPILE_FAIL_RETRIES)
+static constexpr IPASS::RF24L01_Config compile_fail_config = IPASS::RF24L01_Config().retries(16, 3);
+#endif
+#ifdef IPASS_COMPILE_FAIL
+[[maybe_unused]] static void compile_fail(IPASS::RF24L01 &chip) {
+    chip.apply<compile_fail_config>();
+}
+#endif
+
+//apply() writes every register once and reads none, so bring-up costs a fixed amount of SPI-transactions
+static void test_RF24L01_Config() {
+    IPASS::RF24L01_Air air;
+    IPASS::RF24L01_Sim radio_legacy(air);
+    IPASS::SPI_Profiler profiler_legacy(radio_legacy.bus, radio_legacy.csn);
+    const std::array<uint8_t, 5> address = {0xe7, 0xe7, 0xe7, 0xe7, 0xe7};
+    hwlib::host::reset_clock();
+    {
+        IPASS::SPI_Profiler::scope measure(profiler_legacy, "constructor");
+        IPASS::RF24L01 chip(profiler_legacy, radio_legacy.ce, profiler_legacy.select, radio_legacy.irq, address,
+                            address, 0x11, false);
+        chip.change_RX_PW_P(0, 5);
+    }
+    uint_fast64_t legacy_us = hwlib::now_us();
+
+    IPASS::RF24L01_Sim radio(air);
+    IPASS::SPI_Profiler profiler(radio.bus, radio.csn);
+    IPASS::RF24L01 chip(profiler, radio.ce, profiler.select, radio.irq);
+    hwlib::host::reset_clock();
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "apply");
+        chip.apply<example_config>();
+    }
+    uint_fast64_t apply_us = hwlib::now_us();
+    hwlib::cout << "      RF24L01 bring-up: constructor " << profiler_legacy.get("constructor").transactions
+                << " transactions " << legacy_us << " us, apply " << profiler.get("apply").transactions
+                << " transactions " << apply_us << " us\n";
+    check(profiler.get("apply").transactions == 11, "RF24L01 apply writes each of the 11 used registers once");
+    check(apply_us < legacy_us, "RF24L01 apply is faster than the constructor");
+    bool same = true;
+    for (uint8_t address_register = 0; address_register <= IPASS::RF24L01::REGISTER::RF_SETUP; address_register++) {
+        same = same and (address_register == IPASS::RF24L01::REGISTER::EN_RXADDR or
+                         radio.peek(address_register) == radio_legacy.peek(address_register));
+    }
+    check(same and radio.peek(IPASS::RF24L01::REGISTER::EN_RXADDR) == 0x01 and
+          radio.peek(IPASS::RF24L01::REGISTER::RX_PW_P0) == 5, "RF24L01 apply gives the registers of the constructor");
+
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "apply dynamic");
+        chip.apply<dynamic_config>();
+    }
+    check(profiler.get("apply dynamic").transactions == 14 and chip.dynamic_payloads_enabled() and
+          radio.peek(IPASS::RF24L01::REGISTER::DYNPD) == 0x01 and
+          radio.peek(IPASS::RF24L01::REGISTER::FEATURE) == 0x07, "RF24L01 apply activates and writes the features");
+}
+
+//gateway that polls two nodes, the nodes only differ in the least significant address byte and the channel
+static void test_switch_profile() {
+    static constexpr IPASS::RF24L01::profile node_1 = {{0xe7, 0xe7, 0xe7, 0xe7, 0x01}, 0x11, 5, false, 3, 0, 3};
+    static constexpr IPASS::RF24L01::profile node_2 = {{0xe7, 0xe7, 0xe7, 0xe7, 0x02}, 0x22, 5, false, 3, 0, 3};
+    static constexpr IPASS::RF24L01_Config node_1_config = IPASS::RF24L01_Config()
+            .rx_address(0, node_1.address)
+            .channel(node_1.channel)
+            .data_rate_2mbps(false)
+            .pipe(0, true, 5)
+            .rx_mode(true);
+    static constexpr IPASS::RF24L01_Config node_2_config = node_1_config
+            .rx_address(0, node_2.address).channel(node_2.channel);
+    IPASS::RF24L01_Air air;
+    IPASS::RF24L01_Sim radio_gateway(air);
+    IPASS::RF24L01_Sim radio_1(air);
+    IPASS::RF24L01_Sim radio_2(air);
+    IPASS::SPI_Profiler profiler(radio_gateway.bus, radio_gateway.csn);
+    IPASS::RF24L01 gateway(profiler, radio_gateway.ce, profiler.select, radio_gateway.irq);
+    IPASS::RF24L01 chip_1(radio_1.bus, radio_1.ce, radio_1.csn, radio_1.irq);
+    IPASS::RF24L01 chip_2(radio_2.bus, radio_2.ce, radio_2.csn, radio_2.irq);
+    gateway.apply<example_config>();
+    chip_1.apply<node_1_config>();
+    chip_2.apply<node_2_config>();
+    radio_1.ce.write(true);
+    radio_2.ce.write(true);
+    hwlib::wait_us(200);
+
+    std::array<uint8_t, 5> data = {};
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "first switch_profile");
+        gateway.switch_profile(node_1);
+    }
+    bool delivered = true;
+    for (uint8_t round = 0; round < 4; round++) {
+        const IPASS::RF24L01::profile &node = round % 2 == 0 ? node_2 : node_1;
+        {
+            IPASS::SPI_Profiler::scope measure(profiler, "switch_profile");
+            gateway.switch_profile(node);
+        }
+        data[0] = round;
+        gateway.write_tx(data);
+        gateway.send_packages();
+        hwlib::wait_ms(1);
+        IPASS::RF24L01 &receiver = round % 2 == 0 ? chip_2 : chip_1;
+        std::array<uint8_t, 5> received = {};
+        delivered = delivered and receiver.packet_received();
+        receiver.read_rx(received);
+        delivered = delivered and received == data;
+    }
+    check(delivered, "RF24L01 switch_profile reaches each node");
+    check(profiler.get("first switch_profile").transactions == 2,
+          "RF24L01 switch_profile after apply only writes the registers that differ");
+    check(profiler.get("switch_profile").transactions == 4 * 3 and profiler.get("switch_profile").bytes == 4 * 6,
+          "RF24L01 switch_profile writes one address byte and the channel");
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "same profile");
+        gateway.switch_profile(node_1);
+    }
+    check(profiler.get("same profile").transactions == 0, "RF24L01 switch_profile to the same peer costs nothing");
+    gateway.set_channel(0x30);
+    gateway.switch_profile(node_1);
+    check(radio_gateway.peek(IPASS::RF24L01::REGISTER::RF_CH) == node_1.channel,
+          "RF24L01 switch_profile writes all registers after another function changed one");
+}
+
+//payloads without ack in a session cost one SPI-transaction, instead of toggling the features per payload
+static void test_no_ack_session() {
+    sim_link<> link;
+
+    std::array<uint8_t, 5> data = {0x10, 0x20, 0x30, 0x40, 0x50};
+    {
+        IPASS::SPI_Profiler::scope measure(link.profiler_tx, "write_tx no_ack");
+        link.chip_tx.write_tx(data, true);
+    }
+    link.chip_tx.send_packages();
+    hwlib::wait_ms(1);
+    std::array<uint8_t, 5> received = {};
+    uint8_t received_count = 0;
+    if (link.chip_rx.packet_received()) {
+        link.chip_rx.read_rx(received);
+        received_count++;
+    }
+    {
+        IPASS::SPI_Profiler::scope measure(link.profiler_tx, "session");
+        IPASS::RF24L01::no_ack_session session(link.chip_tx);
+        for (uint8_t i = 0; i < 4; i++) {
+            data[0] = i;
+            {
+                IPASS::SPI_Profiler::scope measure_write(link.profiler_tx, "write_tx no_ack session");
+                link.chip_tx.write_tx(data, true);
+            }
+            {
+                IPASS::SPI_Profiler::scope measure_send(link.profiler_tx, "send_packages");
+                link.chip_tx.send_packages();
+            }
+            hwlib::wait_us(500);
+            if (link.chip_rx.packet_received()) {
+                link.chip_rx.read_rx(received);
+                received_count++;
+            }
+        }
+        check((link.radio_tx.peek(IPASS::RF24L01::REGISTER::STATUS) & IPASS::RF24L01::SETTING::TX_DS.Mask) and
+              link.chip_tx.interrupt_pending(), "RF24L01 no_ack session leaves TX_DS set and the IRQ-pin low");
+    }
+    check(received_count == 5 and received == data, "RF24L01 payloads without ack are received");
+    check(link.profiler_tx.get("write_tx no_ack").transactions >= 6 and
+          link.profiler_tx.get("write_tx no_ack session").transactions == 4,
+          "RF24L01 no_ack session writes a payload in one transaction");
+    check(link.profiler_tx.get("session").transactions == 6,
+          "RF24L01 no_ack session costs 6 transactions to start and stop");
+    check(link.radio_tx.peek(IPASS::RF24L01::REGISTER::FEATURE) == 0x00 and
+          link.radio_tx.peek(IPASS::RF24L01::REGISTER::OBSERVE_TX) == 0,
+          "RF24L01 no_ack session restores FEATURE and sends no retransmits");
+}
+
+//request/response in one exchange: the receiver answers every request with a queued acknowledgement payload
+static void test_ack_channel() {
+    static constexpr IPASS::RF24L01_Config ack_config = example_config.dynamic_payloads(0x01).features(true, false);
+    sim_link<example_config, ack_config> link;
+    link.chip_tx.enable_ack_payloads(0x01);
+    IPASS::RF24L01_RX_Engine<5, 8> engine(link.chip_rx);
+    IPASS::RF24L01_Ack_Channel<4, 4> replies(link.chip_rx);
+    for (uint8_t i = 0; i < 4; i++) {
+        const uint8_t reply[4] = {0xA0, i, 0, 0};
+        replies.queue(0, reply, i % 2 == 0 ? 4 : 2);
+    }
+    check(replies.pending(0) == 4 and link.radio_rx.peek(IPASS::RF24L01::REGISTER::FIFO_STATUS) == 0x01,
+          "RF24L01_Ack_Channel loads one reply and queues the others");
+
+    bool answered = true;
+    IPASS::RF24L01_RX_Engine<5, 8>::packet packet = {};
+    for (uint8_t i = 0; i < 4; i++) {
+        std::array<uint8_t, 5> request = {i, 0, 0, 0, 0};
+        link.chip_tx.write_tx(request);
+        link.chip_tx.send_packages();
+        hwlib::wait_ms(1);
+        engine.poll();
+        while (engine.pop(packet)) {
+            replies.payload_received(packet.pipe);
+        }
+        uint8_t response[4] = {};
+        size_t length = link.chip_tx.read_ack_payload(response, sizeof(response));
+        answered = answered and length == (i % 2 == 0 ? 4u : 2u) and response[0] == 0xA0 and response[1] == i;
+    }
+    check(answered, "RF24L01 every request gets its reply in the acknowledgement");
+    check(replies.pending(0) == 0 and link.radio_tx.peek(IPASS::RF24L01::REGISTER::CONFIG) == 0x0E,
+          "RF24L01_Ack_Channel sends all replies without a role swap");
+
+    //request and response: the reply of request i is queued after request i is received and goes back with the
+    //acknowledgement of request i + 1
+    bool one_loaded = true;
+    answered = true;
+    for (uint8_t i = 0; i < 6; i++) {
+        std::array<uint8_t, 5> request = {0, 0, 0, 0, uint8_t(0x40 + i)};
+        link.chip_tx.write_tx(request);
+        link.chip_tx.send_packages();
+        hwlib::wait_ms(1);
+        uint8_t response[4] = {};
+        size_t length = link.chip_tx.read_ack_payload(response, sizeof(response));
+        answered = answered and (i == 0 ? length == 0 : length == 2 and response[0] == 0xB0 and
+                                                        response[1] == 0x40 + i - 1);
+        engine.poll();
+        while (engine.pop(packet)) {
+            //the reply is queued before payload_received(), the FIFO shows that it's still loaded
+            const uint8_t reply[2] = {0xB0, packet.data[4]};
+            replies.queue(packet.pipe, reply, 2);
+            replies.payload_received(packet.pipe);
+        }
+        one_loaded = one_loaded and replies.pending(0) == 1 and
+                     (link.radio_rx.peek(IPASS::RF24L01::REGISTER::FIFO_STATUS) & 0x30) == 0x00;
+    }
+    check(answered, "RF24L01_Ack_Channel answers request N with the acknowledgement of request N + 1");
+    check(one_loaded, "RF24L01_Ack_Channel keeps one reply loaded when the reply is queued after its request");
+}
+
+//receiver of test_stream_tx: the second payload stalls the transmitter like a long interrupt, so the TX_DS flags of
+//the payloads that are acknowledged during the stall merge, and the link breaks after stream_break_after payloads
+static IPASS::RF24L01 *stream_chip = nullptr;
+static IPASS::RF24L01_Air *stream_air = nullptr;
+static IPASS::RF24L01_Sim *stream_radio_tx = nullptr;
+static uint32_t stream_received = 0;
+static uint32_t stream_break_after = 0;
+static bool stream_refilled = false;
+
+static void stream_receiver() {
+    std::array<uint8_t, 5> data = {};
+    bool stall = false;
+    if (stream_received > 2 and stream_received < stream_break_after) {
+        // the TX_DS flags merged during the stall, the transmitter still fills the TX FIFO after it
+        stream_refilled = stream_refilled or (stream_radio_tx->peek(IPASS::RF24L01::REGISTER::FIFO_STATUS) &
+                                              IPASS::RF24L01::SETTING::TX_FULL.Mask);
+    }
+    while (stream_chip->packet_received()) {
+        stream_chip->read_rx(data);
+        stream_received++;
+        stall = true;
+        if (stream_received == stream_break_after) {
+            stream_air->set_loss(1000);
+        }
+    }
+    if (stall and stream_received == 2) {
+        hwlib::wait_us(1'500);
+    }
+}
+
+//MAX_RT in the middle of a stream after TX_DS flags merged
+static void test_stream_tx() {
+    sim_link<> link;
+    std::array<std::array<uint8_t, 5>, 12> payloads = {};
+    for (uint8_t i = 0; i < payloads.size(); i++) {
+        payloads[i] = {0, 0, 0, 0, i};
+    }
+    stream_chip = &link.chip_rx;
+    stream_air = &link.air;
+    stream_radio_tx = &link.radio_tx;
+    stream_received = 0;
+    stream_refilled = false;
+    stream_break_after = 10;
+    hwlib::host::background = stream_receiver;
+    const IPASS::RF24L01::stream_result result = link.chip_tx.stream_tx(payloads);
+    hwlib::host::background = nullptr;
+    hwlib::cout << "      MAX_RT after " << stream_received << " payloads, " << link.chip_tx.statistics().tx_ds
+                << " TX_DS flags seen, failed_index " << result.failed_index << "\n";
+    check(link.chip_tx.statistics().tx_ds < stream_received, "RF24L01 stream_tx merges TX_DS flags during a stall");
+    check(stream_refilled, "RF24L01 stream_tx fills the TX FIFO after TX_DS flags merged");
+    check(result.failed and result.failed_index == stream_received and result.sent == stream_received and
+          stream_received >= stream_break_after, "RF24L01 stream_tx failed_index is the first unacknowledged payload");
+    check(link.radio_tx.peek(IPASS::RF24L01::REGISTER::FIFO_STATUS) & IPASS::RF24L01::SETTING::TX_EMPTY.Mask,
+          "RF24L01 stream_tx flushes the TX FIFO after MAX_RT");
+}
+
+//receiver of test_transport, runs in the background of the virtual clock like a second microcontroller, the link
+//breaks for transport_outage_us after transport_outage_at fragments
+static IPASS::RF24L01_RX_Engine<32, 8> *transport_engine = nullptr;
+static IPASS::RF24L01_Reassembler<32, 1024> *transport_reassembler = nullptr;
+static IPASS::RF24L01_Air *transport_air = nullptr;
+static uint32_t transport_fragments = 0;
+static uint32_t transport_outage_at = 0;
+static uint_fast64_t transport_outage_us = 0;
+static uint_fast64_t transport_outage_end = 0;
+
+static void transport_receiver() {
+    transport_engine->poll();
+    IPASS::RF24L01_RX_Engine<32, 8>::packet packet = {};
+    while (transport_engine->pop(packet)) {
+        transport_reassembler->on_fragment(packet.data);
+        transport_fragments++;
+        if (transport_fragments == transport_outage_at) {
+            transport_air->set_loss(1000);
+            transport_outage_end = hwlib::now_us() + transport_outage_us;
+        }
+    }
+    if (transport_outage_end != 0 and hwlib::now_us() >= transport_outage_end) {
+        transport_air->set_loss(0);
+        transport_outage_end = 0;
+    }
+}
+
+//transfer of a firmware chunk of 1 KiB and of a frame of 60 LEDs in fragments of 32 bytes
+static void test_transport() {
+    static constexpr IPASS::RF24L01_Config transport_config = example_config.data_rate_2mbps(true).pipe(0, true, 32);
+    sim_link<transport_config> link;
+    IPASS::RF24L01_RX_Engine<32, 8> engine(link.chip_rx);
+    IPASS::RF24L01_Reassembler<32, 1024> reassembler;
+    IPASS::RF24L01_Transport_TX<32> transport(link.chip_tx);
+    transport_engine = &engine;
+    transport_reassembler = &reassembler;
+    transport_air = &link.air;
+    transport_fragments = 0;
+    transport_outage_at = 0;
+    hwlib::host::background = transport_receiver;
+
+    static std::array<uint8_t, 1024> firmware = {};
+    for (size_t i = 0; i < firmware.size(); i++) {
+        firmware[i] = uint8_t(i * 7 + (i >> 8));
+    }
+    uint_fast64_t start = hwlib::now_us();
+    bool sent = transport.send(firmware.begin(), firmware.size());
+    hwlib::wait_us(500);
+    uint_fast64_t duration = hwlib::now_us() - start;
+    bool same = reassembler.complete() and reassembler.message_length() == firmware.size();
+    for (size_t i = 0; same and i < firmware.size(); i++) {
+        same = reassembler.message()[i] == firmware[i];
+    }
+    hwlib::cout << "      transport of 1024 bytes in 37 fragments: " << duration << " us, "
+                << uint32_t(firmware.size() * 8 * 1000 / duration) << " kbit/s\n";
+    check(sent and same, "RF24L01_Transport 1 KiB arrives complete and in order");
+
+    std::array<uint8_t, 240> frame = {};
+    frame.fill(0xE5);
+    start = hwlib::now_us();
+    transport.send(frame.begin(), frame.size());
+    hwlib::wait_us(500);
+    hwlib::cout << "      transport of a frame of 60 LEDs: " << hwlib::now_us() - start << " us\n";
+    check(reassembler.complete() and reassembler.message_length() == 240 and reassembler.message()[239] == 0xE5,
+          "RF24L01_Transport LED frame arrives complete");
+
+    //the link breaks in the middle of the message, send() streams again from the failed fragment
+    transport_fragments = 0;
+    transport_outage_at = 12;
+    transport_outage_us = 3'000;
+    link.chip_tx.reset_statistics();
+    const uint32_t duplicates = reassembler.duplicate_count();
+    const bool resent = transport.send(firmware.begin(), firmware.size());
+    hwlib::wait_us(500);
+    same = reassembler.complete() and reassembler.message_length() == firmware.size();
+    for (size_t i = 0; same and i < firmware.size(); i++) {
+        same = reassembler.message()[i] == firmware[i];
+    }
+    hwlib::cout << "      transport with an outage: " << link.chip_tx.statistics().max_rt << " MAX_RT, "
+                << transport_fragments << " fragments received\n";
+    check(resent and same and link.chip_tx.statistics().max_rt >= 1 and transport_fragments == 37 and
+          reassembler.duplicate_count() == duplicates,
+          "RF24L01_Transport resends from the failed fragment after MAX_RT");
+    transport_outage_at = 0;
+
+    //duplicate and gap detection
+    IPASS::RF24L01_Reassembler<32, 1024> detector;
+    IPASS::RF24L01_Fragment<32>::view fragments(firmware.begin(), 100, 7);
+    detector.on_fragment(fragments[0]);
+    detector.on_fragment(fragments[0]);
+    detector.on_fragment(fragments[2]);
+    check(detector.duplicate_count() == 1 and detector.missing() == 2, "RF24L01_Reassembler detects duplicates");
+    IPASS::RF24L01_Fragment<32>::view next(firmware.begin(), 10, 8);
+    check(detector.on_fragment(next[0]) and detector.gap_count() == 2 and detector.message_length() == 10,
+          "RF24L01_Reassembler counts the gap of a dropped message");
+    hwlib::host::background = nullptr;
+}
+
+//statistics of a lossy link, the interrupt counters cost no extra SPI-transaction
+static void test_link_statistics() {
+    sim_link<> link;
+    link.chip_tx.reset_statistics();
+    link.chip_rx.reset_statistics();
+    link.air.set_loss(400);
+
+    std::array<uint8_t, 5> data = {};
+    for (uint8_t i = 0; i < 20; i++) {
+        data[0] = i;
+        link.chip_tx.write_tx(data);
+        link.chip_tx.send_packages();
+        hwlib::wait_ms(5);
+        link.chip_tx.update_status();
+        if (link.chip_tx.last_status(IPASS::RF24L01::SETTING::TX_DS) or
+            link.chip_tx.last_status(IPASS::RF24L01::SETTING::MAX_RT)) {
+            link.chip_tx.register_write(IPASS::RF24L01::REGISTER::STATUS, 0x70);
+        }
+        link.chip_tx.sample_link_statistics();
+        if (link.chip_tx.last_status(IPASS::RF24L01::SETTING::MAX_RT)) {
+            link.chip_tx.flush_rx_tx();
+        }
+        std::array<uint8_t, 5> received = {};
+        while (link.chip_rx.packet_received()) {
+            link.chip_rx.read_rx(received);
+        }
+    }
+    const IPASS::RF24L01::link_statistics &tx = link.chip_tx.statistics();
+    hwlib::cout << "      20 payloads at 40% loss: " << tx.tx_ds << " acknowledged, " << tx.max_rt << " MAX_RT, "
+                << tx.retransmits << " retransmits, " << tx.lost << " lost\n";
+    check(tx.tx_ds + tx.max_rt == 20 and tx.samples == 20, "RF24L01 statistics count TX_DS and MAX_RT");
+    check(tx.retransmits > 0 and tx.lost == tx.max_rt, "RF24L01 statistics count retransmits and lost payloads");
+
+    link.air.set_loss(0);
+    for (uint8_t i = 0; i < 3; i++) {
+        link.chip_tx.write_tx(data);
+        link.chip_tx.send_packages();
+        hwlib::wait_ms(5);
+    }
+    link.chip_rx.sample_link_statistics();
+    link.air.set_interference(0x11, 1000);
+    link.chip_rx.sample_link_statistics();
+    check(link.chip_rx.statistics().rx_full == 2 and link.chip_rx.statistics().carrier == 2,
+          "RF24L01 statistics sample a full RX FIFO and a carrier");
+    link.chip_tx.reset_statistics();
+    check(link.chip_tx.statistics().tx_ds == 0 and link.chip_tx.statistics().samples == 0, "RF24L01 reset_statistics");
+}
+
+//a sweep costs 2 SPI-transactions per channel and ranks the channels without a carrier
+static void test_scanner() {
+    IPASS::RF24L01_Air air;
+    IPASS::RF24L01_Sim radio(air);
+    IPASS::SPI_Profiler profiler(radio.bus, radio.csn);
+    IPASS::RF24L01 chip(profiler, radio.ce, profiler.select, radio.irq);
+    chip.apply<example_config>();
+    air.set_interference(0x01, 1000);
+    air.set_interference(0x11, 200);
+    air.set_interference(0x50, 1000);
+    IPASS::RF24L01_Scanner scanner(chip);
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "scan");
+        scanner.scan(4);
+    }
+    check(scanner.sweep_count() == 4 and scanner.occupancy(0x01) == 4 and scanner.occupancy(0x11) == 4 and
+          scanner.occupancy(0x50) == 4 and scanner.occupancy(0x12) == 0 and scanner.occupancy(0x7D) == 0,
+          "RF24L01_Scanner counts the carriers per channel");
+    const std::array<uint8_t, 4> expected = {0x03, 0x04, 0x05, 0x06};
+    check(scanner.quietest<4>() == expected, "RF24L01_Scanner ranks the channels next to a carrier lower");
+    hwlib::cout << "      4 sweeps of 126 channels: " << profiler.get("scan").transactions << " transactions, "
+                << profiler.get("scan").bytes << " bytes\n";
+    check(profiler.get("scan").transactions == 4 * 126 * 2 + 10, "RF24L01_Scanner costs 2 SPI-transactions per hop");
+    check(radio.peek(IPASS::RF24L01::REGISTER::RF_CH) == 0x11 and
+          radio.peek(IPASS::RF24L01::REGISTER::CONFIG) == example_config.config,
+          "RF24L01_Scanner writes the channel and CONFIG back");
+    scanner.reset();
+    check(scanner.sweep_count() == 0 and scanner.occupancy(0x01) == 0, "RF24L01_Scanner reset");
+
+    //start_RX, a pulse of CE around the hop and the channel that's written back, and stop_RX
+    hwlib::host::pin_out_recorder<8> ce;
+    IPASS::RF24L01 chip_ce(radio.bus, ce, radio.csn, radio.irq);
+    IPASS::RF24L01_Scanner single(chip_ce, 200, 0x05, 0x05);
+    single.scan();
+    check(ce.size() == 6 and ce[1].level == false and ce[2].level == true and not ce.level(),
+          "RF24L01_Scanner pulses CE low around the write of RF_CH");
+}
+
+//receiver of test_hopper, runs in the background of the virtual clock like a second microcontroller
+static IPASS::RF24L01 *hopper_chip = nullptr;
+static IPASS::RF24L01_Hopper<8> *hopper_rx = nullptr;
+static uint32_t hopper_received = 0;
+
+static void hopper_receiver() {
+    std::array<uint8_t, 5> data = {};
+    if (hopper_rx != nullptr) {
+        if (hopper_rx->receive(data)) {
+            hopper_received++;
+        }
+    } else {
+        while (hopper_chip->packet_received()) {
+            hopper_chip->read_rx(data);
+            hopper_received++;
+        }
+    }
+}
+
+//a Wi-Fi interferer on channel 1-23, a fixed link on channel 0x11 against a hopping link over 8 channels
+static void test_hopper() {
+    static constexpr std::array<uint8_t, 8> channel_set = {0x08, 0x11, 0x28, 0x34, 0x40, 0x4C, 0x58, 0x64};
+    static constexpr uint_fast64_t duration = 200'000;
+    std::array<uint32_t, 2> delivered = {};
+    for (uint8_t hopping = 0; hopping < 2; hopping++) {
+        sim_link<> link;
+        for (uint8_t channel = 0x01; channel <= 0x17; channel++) {
+            link.air.set_interference(channel, 900);
+        }
+        IPASS::RF24L01_Hopper<8> hopper_tx(link.chip_tx, channel_set, 0x1A2B3C4D);
+        IPASS::RF24L01_Hopper<8> receiver(link.chip_rx, channel_set, 0x1A2B3C4D);
+        if (hopping) {
+            hopper_tx.start();
+            receiver.start();
+            hopper_rx = &receiver;
+        }
+        hopper_chip = &link.chip_rx;
+        hopper_received = 0;
+        hwlib::host::background = hopper_receiver;
+
+        std::array<uint8_t, 5> data = {};
+        uint32_t acknowledged = 0;
+        const uint_fast64_t end = hwlib::now_us() + duration;
+        for (uint16_t i = 0; hwlib::now_us() < end; i++) {
+            data[0] = i;
+            data[1] = i >> 8;
+            if (hopping) {
+                acknowledged += hopper_tx.send(data);
+            } else {
+                const std::array<std::array<uint8_t, 5>, 1> payloads = {data};
+                acknowledged += not link.chip_tx.stream_tx(payloads).failed;
+            }
+        }
+        hwlib::wait_us(1000);
+        hwlib::host::background = nullptr;
+        hopper_rx = nullptr;
+        delivered[hopping] = hopper_received;
+        if (hopping) {
+            hwlib::cout << "      hopping over 8 channels: " << acknowledged << " of " << data[0] + (data[1] << 8) + 1
+                        << " acknowledged, " << receiver.resync_count() << " resync hops\n";
+            for (uint8_t channel = 0x01; channel <= 0x17; channel++) {
+                link.air.set_interference(channel, 0);
+            }
+            hopper_rx = &receiver;
+            hwlib::host::background = hopper_receiver;
+            uint8_t last = 0;
+            for (uint8_t i = 0; i < 8; i++) {
+                last = hopper_tx.send(data) ? last + 1 : 0;
+            }
+            hwlib::wait_us(500);
+            hwlib::host::background = nullptr;
+            hopper_rx = nullptr;
+            check(last >= 4 and receiver.channel() == hopper_tx.channel(),
+                  "RF24L01_Hopper receiver follows the transmitter");
+            {
+                IPASS::SPI_Profiler::scope measure(link.profiler_tx, "hop");
+                hopper_tx.hop();
+            }
+            check(link.profiler_tx.get("hop").transactions == 1, "RF24L01_Hopper hops with one RF_CH write");
+        } else {
+            hwlib::cout << "      fixed channel 0x11: " << acknowledged << " of " << data[0] + (data[1] << 8) + 1
+                        << " acknowledged, " << hopper_received << " received\n";
+        }
+    }
+    check(delivered[1] > 2 * delivered[0], "RF24L01_Hopper sustains the throughput next to an interferer");
+    IPASS::RF24L01_Air air;
+    IPASS::RF24L01_Sim radio(air);
+    IPASS::RF24L01 chip(radio.bus, radio.ce, radio.csn, radio.irq);
+    IPASS::RF24L01_Hopper<8> a(chip, channel_set, 7);
+    IPASS::RF24L01_Hopper<8> b(chip, channel_set, 7);
+    IPASS::RF24L01_Hopper<8> c(chip, channel_set, 8);
+    bool same = true;
+    bool different = false;
+    uint16_t used = 0;
+    for (size_t i = 0; i < 8; i++) {
+        same = same and a[i] == b[i];
+        different = different or a[i] != c[i];
+        for (uint8_t channel : channel_set) {
+            used += a[i] == channel;
+        }
+    }
+    check(same and different and used == 8, "RF24L01_Hopper sequence is a permutation given by the seed");
+
+    hwlib::host::pin_out_recorder<8> ce;
+    IPASS::RF24L01 chip_ce(radio.bus, ce, radio.csn, radio.irq);
+    IPASS::RF24L01_Hopper<8> receiver(chip_ce, channel_set, 7);
+    chip_ce.start_RX();
+    receiver.hop();
+    check(ce.size() == 3 and ce[1].level == false and ce.level() and
+          radio.peek(IPASS::RF24L01::REGISTER::RF_CH) == receiver.channel(),
+          "RF24L01_Hopper pulses CE low around the hop of the receiver");
+}
+
+//a burst that fills the RX FIFO is read with one SPI-transaction per payload and one clear of RX_DR
+static void test_drain_rx() {
+    static constexpr IPASS::RF24L01_Config dynamic_rx_config = dynamic_config.rx_mode(true);
+    sim_link<> link;
+    auto burst = [&](uint8_t amount, bool dynamic) {
+        for (uint8_t i = 0; i < amount; i++) {
+            const uint8_t data[5] = {i, 1, 2, 3, 4};
+            link.chip_tx.write_tx(data, dynamic ? i + 1 : 5);
+            link.chip_tx.send_packages();
+            hwlib::wait_ms(1);
+        }
+    };
+
+    burst(3, false);
+    std::array<IPASS::RF24L01::received_payload, 4> payloads = {};
+    size_t drained = 0;
+    {
+        IPASS::SPI_Profiler::scope measure(link.profiler_rx, "drain_rx");
+        drained = link.chip_rx.drain_rx(payloads.begin(), payloads.size(), 5);
+    }
+    bool in_order = drained == 3;
+    for (uint8_t i = 0; in_order and i < 3; i++) {
+        in_order = payloads[i].data[0] == i and payloads[i].data[4] == 4 and payloads[i].pipe == 0 and
+                   payloads[i].length == 5;
+    }
+    check(in_order, "RF24L01 drain_rx reads a full RX FIFO in order");
+    check(link.profiler_rx.get("drain_rx").transactions == 3 + 2 and not link.chip_rx.interrupt_pending() and
+          link.radio_rx.peek(IPASS::RF24L01::REGISTER::FIFO_STATUS) & IPASS::RF24L01::SETTING::RX_EMPTY.Mask,
+          "RF24L01 drain_rx costs one SPI-transaction per payload and clears RX_DR once");
+
+    burst(3, false);
+    drained = link.chip_rx.drain_rx(payloads.begin(), 2, 5);
+    check(drained == 2 and link.chip_rx.interrupt_pending() and link.chip_rx.drain_rx(payloads.begin(), 2, 5) == 1 and
+          payloads[0].data[0] == 2, "RF24L01 drain_rx leaves the payloads that don't fit in the RX FIFO");
+
+    link.chip_tx.apply<dynamic_config>();
+    link.chip_rx.apply<dynamic_rx_config>();
+    link.radio_rx.ce.write(true);
+    hwlib::wait_us(200);
+    burst(3, true);
+    size_t total = 0;
+    {
+        IPASS::SPI_Profiler::scope measure(link.profiler_rx, "drain_rx callback");
+        link.chip_rx.drain_rx([&total](uint8_t pipe, const uint8_t data[], size_t length) {
+            total += (pipe == 0 and data[0] + 1 == uint8_t(length)) ? length : 100;
+        });
+    }
+    check(total == 1 + 2 + 3 and link.profiler_rx.get("drain_rx callback").transactions == 2 * 3 + 2,
+          "RF24L01 drain_rx hands payloads with a dynamic length to a callback");
+}
+
+//outcomes of the payloads of test_async_tx in the order of their callbacks
+struct async_log {
+    std::array<uint16_t, 8> handles;
+    std::array<IPASS::RF24L01_Async_TX<5, 4>::outcome, 8> outcomes;
+    size_t count;
+};
+
+static void async_done(void *context, uint16_t handle, IPASS::RF24L01_Async_TX<5, 4>::outcome result) {
+    async_log &log = *static_cast<async_log *>(context);
+    if (log.count < log.handles.size()) {
+        log.handles[log.count] = handle;
+        log.outcomes[log.count] = result;
+        log.count++;
+    }
+}
+
+//receiver of test_async_tx, runs in the background of the virtual clock like a second microcontroller
+static IPASS::RF24L01 *async_receiver_chip = nullptr;
+static size_t async_received = 0;
+
+static void async_receiver() {
+    if (async_receiver_chip->interrupt_pending()) {
+        async_received += async_receiver_chip->drain_rx([](uint8_t, const uint8_t[], size_t) {}, 5);
+    }
+}
+
+//3 transmitters on pipe 1-3 of one receiver, every pipe with its own payload width
+static void test_demux() {
+    IPASS::RF24L01_Air air;
+    IPASS::RF24L01_Sim radio_rx(air);
+    IPASS::SPI_Profiler profiler(radio_rx.bus, radio_rx.csn);
+    IPASS::RF24L01 chip_rx(profiler, radio_rx.ce, profiler.select, radio_rx.irq);
+    chip_rx.apply<example_config>();
+    const std::array<uint8_t, 5> base = {0xC2, 0xC2, 0xC2, 0xC2, 0x00};
+    chip_rx.configure_pipes(base, {{{false, 0x00, 5, true}, {true, 0x01, 4, true}, {true, 0x02, 8, true},
+                                    {true, 0x03, 12, true}, {false, 0x04, 0, false}, {false, 0x05, 0, false}}});
+    chip_rx.start_RX();
+    hwlib::wait_us(200);
+    check(radio_rx.peek(IPASS::RF24L01::REGISTER::EN_RXADDR) == 0x0E and
+          radio_rx.peek(IPASS::RF24L01::REGISTER::RX_PW_P2) == 8 and
+          radio_rx.peek(IPASS::RF24L01::REGISTER::RX_PW_P3) == 12,
+          "RF24L01 configure_pipes enables pipe 1-3 with their widths");
+
+    IPASS::RF24L01_Pipe_Queue<4> queue_1, queue_2, queue_3;
+    IPASS::RF24L01_Demux demux(chip_rx);
+    demux.bind(1, queue_1);
+    demux.bind(2, queue_2);
+    demux.bind(3, queue_3);
+    IPASS::RF24L01_Sim radio_tx(air);
+    IPASS::RF24L01 chip_tx(radio_tx.bus, radio_tx.ce, radio_tx.csn, radio_tx.irq);
+    chip_tx.apply<example_config>();
+    auto send = [&](uint8_t pipe, uint8_t width) {
+        std::array<uint8_t, 5> address = base;
+        address[4] = pipe;
+        chip_tx.change_ADDR(IPASS::RF24L01::REGISTER::TX_ADDR, address);
+        chip_tx.change_ADDR(IPASS::RF24L01::REGISTER::RX_ADDR_P0, address);
+        uint8_t data[12] = {};
+        for (uint8_t i = 0; i < width; i++) {
+            data[i] = uint8_t(pipe * 0x10 + i);
+        }
+        chip_tx.write_tx(data, width);
+        chip_tx.send_packages();
+        hwlib::wait_ms(1);
+    };
+    send(3, 12);
+    send(1, 4);
+    send(2, 8);
+    size_t polled = 0;
+    {
+        IPASS::SPI_Profiler::scope measure(profiler, "poll");
+        polled = demux.poll();
+    }
+    bool routed = polled == 3;
+    IPASS::RF24L01_Pipe_Queue<4>::payload payload = {};
+    uint8_t pipe = 1;
+    for (IPASS::RF24L01_Pipe_Queue<4> *queue : {&queue_1, &queue_2, &queue_3}) {
+        routed = routed and queue->pop(payload) and payload.pipe == pipe and payload.length == pipe * 4 and
+                 payload.data[0] == pipe * 0x10 and payload.data[payload.length - 1] == pipe * 0x10 + pipe * 4 - 1 and
+                 not queue->pop(payload);
+        pipe++;
+    }
+    check(routed, "RF24L01_Demux routes the payload of every pipe to its handler with the width of the pipe");
+    check(profiler.get("poll").transactions == 3 + 2 and not chip_rx.interrupt_pending(),
+          "RF24L01_Demux costs one SPI-transaction per payload");
+    demux.unbind(2);
+    send(2, 8);
+    check(demux.poll() == 1 and demux.unhandled_count() == 1 and not queue_2.pop(payload),
+          "RF24L01_Demux counts the payloads of a pipe without a handler");
+}
+
+//the main loop keeps running while the payloads are in flight, each payload costs 2 SPI-transactions
+static void test_async_tx() {
+    using async_tx = IPASS::RF24L01_Async_TX<5, 4>;
+    sim_link<> link;
+    async_receiver_chip = &link.chip_rx;
+    async_received = 0;
+    hwlib::host::background = async_receiver;
+
+    async_tx transmitter(link.chip_tx);
+    async_log log = {};
+    uint8_t data[5] = {0, 1, 2, 3, 4};
+    uint32_t loops = 0;
+    {
+        IPASS::SPI_Profiler::scope measure(link.profiler_tx, "async");
+        //the queue of 4 and the payload in flight
+        for (uint8_t i = 0; i < 5; i++) {
+            data[0] = i;
+            transmitter.submit(data, 5, async_done, &log);
+        }
+        check(transmitter.submit(data, 5) == 0, "RF24L01_Async_TX rejects a payload when the queue is full");
+        while (transmitter.pending() > 0 and loops < 10'000) {
+            hwlib::wait_us(20);
+            transmitter.poll();
+            loops++;
+        }
+    }
+    check(log.count == 5 and log.handles[0] == 1 and log.handles[4] == 5 and
+          log.outcomes[4] == async_tx::outcome::delivered and transmitter.delivered() == 5 and async_received == 5,
+          "RF24L01_Async_TX delivers the queued payloads and calls back in order");
+    hwlib::cout << "      5 payloads in " << loops << " iterations of the main loop, "
+                << link.profiler_tx.get("async").transactions << " SPI-transactions\n";
+    check(link.profiler_tx.get("async").transactions == 5 * 2 + 5 and loops > 5,
+          "RF24L01_Async_TX costs 2 SPI-transactions per payload and doesn't block");
+
+    link.air.set_loss(1000);
+    transmitter.submit(data, 5, async_done, &log);
+    for (uint16_t i = 0; i < 500 and transmitter.pending() > 0; i++) {
+        hwlib::wait_us(20);
+        transmitter.poll();
+    }
+    check(log.count == 6 and log.outcomes[5] == async_tx::outcome::max_rt and transmitter.failed() == 1,
+          "RF24L01_Async_TX reports MAX_RT");
+
+    async_tx impatient(link.chip_tx, 100);
+    impatient.submit(data, 5, async_done, &log);
+    for (uint16_t i = 0; i < 20; i++) {
+        hwlib::wait_us(20);
+        impatient.poll();
+    }
+    check(log.count == 7 and log.outcomes[6] == async_tx::outcome::timeout, "RF24L01_Async_TX reports a timeout");
+    hwlib::host::background = nullptr;
+}
+
+using coroutine_task = IPASS::Coroutine_Task<>;
+using coroutine_radio = IPASS::RF24L01_Coroutine<5, 4, 8>;
+
+static coroutine_task coroutine_sender(coroutine_radio &radio, IPASS::Coroutine_Scheduler<8> &loop, size_t &delivered) {
+    uint8_t data[5] = {0, 1, 2, 3, 4};
+    for (uint8_t i = 0; i < 5; i++) {
+        data[0] = i;
+        if (co_await radio.send(data, 5) == coroutine_radio::async_tx::outcome::delivered) {
+            delivered++;
+        }
+        co_await loop.sleep_us(1000);
+    }
+}
+
+static coroutine_task coroutine_receiver(coroutine_radio &radio, std::array<uint8_t, 5> &order) {
+    for (uint8_t i = 0; i < 5; i++) {
+        IPASS::RF24L01::received_payload payload = co_await radio.receive();
+        order[i] = payload.data[0];
+    }
+}
+
+static coroutine_task coroutine_sensor(IPASS::Coroutine_Scheduler<8> &loop, uint32_t &samples) {
+    while (samples < 1000) {
+        samples++;
+        co_await loop.sleep_us(100);
+    }
+}
+
+static coroutine_task coroutine_yield(IPASS::Coroutine_Scheduler<8> &loop, uint32_t rounds) {
+    for (uint32_t i = 0; i < rounds; i++) {
+        co_await loop.yield();
+    }
+}
+
+//coroutines send, receive and sample at the same time, without heap and with a sub-microsecond resume on the host
+static void test_coroutine() {
+    sim_link<> link;
+
+    IPASS::Coroutine_Scheduler<8> loop;
+    coroutine_radio transmitter(link.chip_tx, loop);
+    coroutine_radio receiver(link.chip_rx, loop);
+    size_t delivered = 0;
+    std::array<uint8_t, 5> order = {};
+    uint32_t samples = 0;
+    loop.spawn(coroutine_sender(transmitter, loop, delivered));
+    loop.spawn(coroutine_receiver(receiver, order));
+    loop.spawn(coroutine_sensor(loop, samples));
+    check(coroutine_task::promise_type::frames_used() == 3, "Coroutine frames come from the pool");
+    const uint_fast64_t start = hwlib::now_us();
+    loop.run();
+    const std::array<uint8_t, 5> expected = {0, 1, 2, 3, 4};
+    hwlib::cout << "      5 payloads and " << samples << " samples in " << hwlib::now_us() - start << " us\n";
+    check(delivered == 5 and order == expected, "RF24L01_Coroutine co_await send() and receive()");
+    check(samples == 1000, "Coroutine_Scheduler runs a sensor loop next to the radio");
+    check(coroutine_task::promise_type::frames_used() == 0, "Coroutine frames go back to the pool");
+
+    using tiny_task = IPASS::Coroutine_Task<64, 1>;
+    auto tiny = [](IPASS::Coroutine_Scheduler<8> &) -> tiny_task {
+        co_return;
+    };
+    tiny_task first = tiny(loop);
+    tiny_task second = tiny(loop);
+    check(first.valid() and not second.valid(), "Coroutine_Task is not created when the pool is empty");
+
+    //a frame size that's not a multiple of the alignment
+    using odd_task = IPASS::Coroutine_Task<100, 3>;
+    auto odd = [](IPASS::Coroutine_Scheduler<8> &) -> odd_task {
+        co_return;
+    };
+    bool aligned = true;
+    odd_task frames[3] = {odd(loop), odd(loop), odd(loop)};
+    for (size_t i = 0; i < 3; i++) {
+        aligned = aligned and frames[i].valid() and
+                  reinterpret_cast<uintptr_t>(odd_task::promise_type::pool[i].bytes) % alignof(std::max_align_t) == 0;
+    }
+    check(aligned, "Coroutine_Task frames are aligned when frame_size is not a multiple of the alignment");
+
+    //scheduler overhead, measured with the clock of the build host instead of the virtual clock: this is no figure for
+    //the Due, which runs at 84 MHz and has no build of the coroutine example yet
+    static constexpr uint32_t rounds = 200'000;
+    loop.spawn(coroutine_yield(loop, rounds));
+    loop.spawn(coroutine_yield(loop, rounds));
+    const auto begin = std::chrono::steady_clock::now();
+    loop.run();
+    const auto end = std::chrono::steady_clock::now();
+    const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    const uint64_t per_resume = ns / (2 * rounds);
+    hwlib::cout << "      " << 2 * rounds << " resumes in " << ns / 1000 << " us, " << per_resume
+                << " ns per resume on the build host\n";
+    check(per_resume < 1000, "Coroutine_Scheduler resumes in less than a microsecond on the build host");
+}
+
+//state of the tasks of test_deadline_scheduler, the firmware of IPASS_RF24L01_TX and IPASS_RF24L01_RX on one clock
+struct scheduler_firmware {
+    IPASS::Deadline_Scheduler<8> *loop;
+    hwlib::pin_in *button;
+    bool pressed;
+    IPASS::RF24L01_Async_TX<5, 4> *transmitter;
+    IPASS::RF24L01_RX_Engine<5, 8> *receiver;
+    size_t refresh;
+    std::array<uint8_t, 5> leds;
+    uint_fast64_t refreshed_us;
+};
+
+static void count_task(void *context) {
+    (*static_cast<uint32_t *>(context))++;
+}
+
+static void slow_task(void *context) {
+    (*static_cast<uint32_t *>(context))++;
+    hwlib::wait_us(2'500);
+}
+
+//a task that triggers another task after some work, like firmware_radio_rx triggers the refresh
+struct trigger_context {
+    IPASS::Deadline_Scheduler<2> *loop;
+    size_t target;
+};
+
+static void trigger_task(void *context) {
+    trigger_context &trigger = *static_cast<trigger_context *>(context);
+    hwlib::wait_us(5);
+    trigger.loop->trigger(trigger.target);
+}
+
+static void firmware_buttons(void *context) {
+    scheduler_firmware &firmware = *static_cast<scheduler_firmware *>(context);
+    bool level = firmware.button->read();
+    if (level and not firmware.pressed) {
+        const uint8_t data[5] = {0x00, 0x80, 0x30, 0x20, 0x10};
+        firmware.transmitter->submit(data, 5);
+    }
+    firmware.pressed = level;
+}
+
+static void firmware_radio_tx(void *context) {
+    static_cast<scheduler_firmware *>(context)->transmitter->poll();
+}
+
+static void firmware_radio_rx(void *context) {
+    scheduler_firmware &firmware = *static_cast<scheduler_firmware *>(context);
+    firmware.receiver->poll();
+    IPASS::RF24L01_RX_Engine<5, 8>::packet packet_in = {};
+    while (firmware.receiver->pop(packet_in)) {
+        firmware.leds = packet_in.data;
+        firmware.loop->trigger(firmware.refresh);
+    }
+}
+
+static void firmware_refresh(void *context) {
+    static_cast<scheduler_firmware *>(context)->refreshed_us = hwlib::now_us();
+}
+
+static void test_deadline_scheduler() {
+    IPASS::Deadline_Scheduler<8> loop;
+    uint32_t fast = 0, slow = 0, event = 0;
+    hwlib::host::reset_clock();
+    size_t fast_id = loop.add(count_task, &fast, 250);
+    loop.add(count_task, &slow, 1'000, 500);
+    size_t event_id = loop.add_event(count_task, &event);
+    loop.run_until(10'000);
+    check(fast == 41 and slow == 10 and event == 0 and loop.max_lateness_us() == 0,
+          "Deadline_Scheduler runs the periodic tasks at their deadline");
+    loop.trigger(event_id, 100);
+    loop.trigger(event_id, 300);
+    check(loop.next_due() == 10'250, "Deadline_Scheduler keeps the tasks ordered on their deadline");
+    loop.run_until(11'000);
+    check(event == 1, "Deadline_Scheduler runs an event task once per trigger()");
+    loop.cancel(fast_id);
+    loop.run_until(12'000);
+    check(fast == 45 and slow == 12, "Deadline_Scheduler::cancel() stops a task");
+    loop.remove(event_id);
+    check(loop.add(count_task, &event, 100) == event_id and loop.add_event(count_task, &event) != loop.none,
+          "Deadline_Scheduler reuses the id of a removed task");
+
+    IPASS::Deadline_Scheduler<2> late;
+    uint32_t late_runs = 0;
+    const uint_fast64_t start = hwlib::now_us();
+    late.add(slow_task, &late_runs, 1'000);
+    late.run_until(start + 10'000);
+    hwlib::cout << "      " << late_runs << " runs of a task of 2500 us, max lateness " << late.max_lateness_us()
+                << " us\n";
+    check(late_runs == 4 and late.max_lateness_us() < 2'500, "Deadline_Scheduler skips the periods a late task missed");
+
+    IPASS::Deadline_Scheduler<2> chain;
+    uint32_t chained = 0;
+    trigger_context trigger = {&chain, chain.add_event(count_task, &chained)};
+    chain.add(trigger_task, &trigger, 1'000);
+    check(chain.run_once() and chained == 1, "Deadline_Scheduler runs a task triggered without delay in the same call");
+    uint32_t always_late = 0;
+    IPASS::Deadline_Scheduler<2> bounded;
+    bounded.add(slow_task, &always_late, 1'000);
+    bounded.run_once();
+    check(always_late == 2, "Deadline_Scheduler::run_once() runs at most capacity tasks");
+
+    IPASS::Deadline_Scheduler<1> once;
+    uint32_t single = 0;
+    once.trigger(once.add_event(count_task, &single), 50);
+    once.run();
+    check(single == 1 and once.next_due() == UINT_FAST64_MAX, "Deadline_Scheduler::run() returns without tasks");
+
+    sim_link<> link;
+    IPASS::RF24L01_Async_TX<5, 4> transmitter(link.chip_tx);
+    IPASS::RF24L01_RX_Engine<5, 8> receiver(link.chip_rx);
+    hwlib::host::pin_in_replay<2> button;
+    const uint_fast64_t press = hwlib::host::clock_ns + 5'300'000;
+    button.pulse(press, 80'000'000);
+
+    IPASS::Deadline_Scheduler<8> firmware_loop;
+    scheduler_firmware firmware = {&firmware_loop, &button, false, &transmitter, &receiver, 0, {}, 0};
+    firmware.refresh = firmware_loop.add_event(firmware_refresh, &firmware);
+    firmware_loop.add(firmware_buttons, &firmware, 1'000);
+    firmware_loop.add(firmware_radio_tx, &firmware, 250);
+    firmware_loop.add(firmware_radio_rx, &firmware, 250);
+    firmware_loop.run_until(hwlib::now_us() + 100'000);
+    const uint_fast64_t latency = firmware.refreshed_us - press / 1'000;
+    hwlib::cout << "      button to LED refresh in " << latency << " us, " << firmware_loop.run_count()
+                << " task runs in 100 ms, " << button.read_count() << " reads of the button\n";
+    check(firmware.refreshed_us > 0 and latency < 2'000 and firmware.leds[0] == 0x10 and firmware.leds[4] == 0x00 and
+          transmitter.delivered() == 1, "Deadline_Scheduler: button press to LED refresh within 2 ms");
+}
+
+using latency_histogram = IPASS::Latency_Histogram<>;
+static_assert(latency_histogram::bucket(31) == 31 and latency_histogram::bucket(32) == 32 and
+              latency_histogram::bucket(63) == 47 and latency_histogram::bucket(64) == 48 and
+              latency_histogram::bucket_high(48) == 67 and
+              latency_histogram::bucket(0xFFFFFF) == latency_histogram::buckets - 1 and
+              latency_histogram::bucket(0xFFFFFFFF) == latency_histogram::buckets - 1,
+              "Latency_Histogram buckets are exact below 32 us and 1/16 of a power of 2 above");
+static_assert(sizeof(latency_histogram) <= 1344 + 32, "Latency_Histogram has a fixed size of 336 counters");
+
+static void test_latency_histogram() {
+    latency_histogram values;
+    for (uint32_t i = 1; i <= 1000; i++) {
+        values.record(i);
+    }
+    check(values.count() == 1000 and values.min() == 1 and values.max() == 1000 and values.mean() == 500 and
+          values.percentile(500) >= 500 and values.percentile(500) <= 500 * 17 / 16 and
+          values.percentile(990) >= 990 and values.percentile(990) <= 1000 and values.percentile(1000) == 1000,
+          "Latency_Histogram percentiles within a bucket of the exact value");
+    values.reset();
+    check(values.count() == 0 and values.percentile(500) == 0 and values.max() == 0, "Latency_Histogram::reset()");
+    {
+        IPASS_LATENCY_SCOPE(values);
+        hwlib::wait_us(150);
+    }
+#ifdef IPASS_LATENCY
+    check(values.count() == 1 and values.max() == 150, "IPASS_LATENCY_SCOPE records the time of its block");
+#else
+    check(values.count() == 0, "IPASS_LATENCY_SCOPE is compiled out without IPASS_LATENCY");
+#endif
+
+    //the entry points of the drivers, measured on the virtual clock of the simulator
+    sim_link<> link;
+    hwlib::host::spi_bus_recorder<64> led_bus;
+    IPASS::APA102 leds(led_bus, 8);
+    latency_histogram press_to_light_us;
+    std::array<uint8_t, 5> data = {1, 2, 3, 4, 5};
+    std::array<uint8_t, 5> data_in = {};
+    uint32_t received = 0;
+    for (uint32_t i = 0; i < 100; i++) {
+        link.chip_tx.write_tx(data);
+        link.chip_tx.send_packages();
+        hwlib::wait_us(1'000);
+        link.chip_rx.read_rx(data_in);
+        received += data_in == data;
+        data_in = {};
+        led_bus.clear();
+        leds.write(IPASS::APA102::yellow, 0xff);
+    }
+
+    //press to light over the link: the firmware of test_deadline_scheduler, presses at a different phase of the tasks
+    IPASS::RF24L01_Sim radio_firmware_rx(link.air);
+    IPASS::RF24L01 chip_firmware_rx(radio_firmware_rx.bus, radio_firmware_rx.ce, radio_firmware_rx.csn,
+                                    radio_firmware_rx.irq);
+    link.chip_rx.stop_RX();
+    chip_firmware_rx.apply<example_config>();
+    chip_firmware_rx.start_RX();
+    hwlib::wait_us(200);
+    IPASS::RF24L01_Async_TX<5, 4> transmitter(link.chip_tx);
+    IPASS::RF24L01_RX_Engine<5, 8> receiver(chip_firmware_rx);
+    hwlib::host::pin_in_replay<2> button;
+    IPASS::Deadline_Scheduler<8> firmware_loop;
+    scheduler_firmware firmware = {&firmware_loop, &button, false, &transmitter, &receiver, 0, {}, 0};
+    firmware.refresh = firmware_loop.add_event(firmware_refresh, &firmware);
+    firmware_loop.add(firmware_buttons, &firmware, 1'000);
+    firmware_loop.add(firmware_radio_tx, &firmware, 250);
+    firmware_loop.add(firmware_radio_rx, &firmware, 250);
+    for (uint32_t i = 0; i < 50; i++) {
+        const uint_fast64_t press_us = hwlib::now_us() + 5'000 + (i * 379) % 1'000;
+        button.clear();
+        button.pulse(press_us * 1'000, 20'000'000);
+        firmware.refreshed_us = 0;
+        firmware_loop.run_until(press_us + 40'000);
+        if (firmware.refreshed_us > press_us) {
+            press_to_light_us.record(uint32_t(firmware.refreshed_us - press_us));
+        }
+    }
+
+#ifdef IPASS_LATENCY
+    link.chip_tx.print_latency();
+    link.chip_rx.print_latency();
+    leds.print_latency();
+    //the transmitter of the link also sent the payloads of the firmware
+    const IPASS::RF24L01::latency_histograms &tx_us = link.chip_tx.latency();
+    check(received == 100 and link.chip_rx.latency().read_rx.count() == 100 and tx_us.write_tx.count() >= 100 and
+          tx_us.send_packages.count() >= 100 and leds.latency().count() >= 100 and
+          link.chip_rx.latency().read_rx.percentile(500) > 0 and
+          tx_us.write_tx.percentile(999) >= tx_us.write_tx.percentile(500),
+          "Latency_Histogram of the driver entry points");
+    link.chip_rx.reset_statistics();
+    check(link.chip_rx.latency().read_rx.count() == 0, "RF24L01::reset_statistics() resets the latency histograms");
+#else
+    check(received == 100, "payloads of the driver entry points received");
+#endif
+    latency_histogram::print_header();
+    press_to_light_us.print("press to light");
+    check(press_to_light_us.count() == 50 and press_to_light_us.percentile(990) < 2'000,
+          "Latency_Histogram: p99 of press to light below 2 ms");
+}
+
+//clock of the transmitter of test_timestamp: an offset and a skew in ppm relative to the virtual clock
+static int32_t timestamp_skew_ppm = 0;
+
+static uint_fast64_t skewed_clock() {
+    const uint_fast64_t now = hwlib::now_us();
+    return now + int_fast64_t(now) * timestamp_skew_ppm / 1'000'000 + 12'345'678;
+}
+
+static void test_timestamp() {
+    static constexpr IPASS::RF24L01_Config timestamp_config = example_config.pipe(0, true, 8);
+    sim_link<timestamp_config> link;
+
+    timestamp_skew_ppm = 200;
+    IPASS::RF24L01_Timestamper stamper(skewed_clock);
+    IPASS::RF24L01_Latency_Estimator estimator;
+    IPASS::Latency_Histogram<> estimated, error;
+    const uint8_t data[4] = {0x10, 0x20, 0x30, 0x40};
+    uint32_t random = 0x2545F491, sent = 0, received = 0;
+    uint_fast64_t transmit_times[256] = {};
+    int_fast64_t true_min = INT64_MAX;
+    const int_fast64_t start_offset = int_fast64_t(skewed_clock()) - int_fast64_t(hwlib::now_us());
+    int_fast64_t true_latency[600] = {}, estimated_latency[600] = {};
+    link.air.set_loss(50);
+    for (uint32_t i = 0; i < 600; i++) {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        transmit_times[stamper.next_sequence()] = hwlib::now_us();
+        stamper.write_tx(link.chip_tx, data, 4, true);
+        //the payload waits 0-400 us in the TX FIFO
+        hwlib::wait_us(random % 400);
+        link.chip_tx.send_packages();
+        sent++;
+        const uint_fast64_t next = hwlib::now_us() + 10'000 + random % 5'000;
+        while (hwlib::now_us() < next) {
+            hwlib::wait_us(20);
+            if (link.chip_rx.interrupt_pending()) {
+                link.chip_rx.drain_rx([&](uint8_t, const uint8_t payload[], size_t) {
+                    const uint32_t latency = estimator.record(payload);
+                    const int_fast64_t real = int_fast64_t(hwlib::now_us() - transmit_times[payload[0]]);
+                    if (received < 600) {
+                        true_latency[received] = real;
+                        estimated_latency[received] = latency;
+                    }
+                    true_min = real < true_min ? real : true_min;
+                    received++;
+                }, 8);
+            }
+        }
+    }
+    link.air.set_loss(0);
+    //the estimate is the latency above the fastest payload, compared after the first windows
+    for (uint32_t i = 0; i < received and i < 600; i++) {
+        estimated.record(uint32_t(estimated_latency[i]));
+        const int_fast64_t difference = estimated_latency[i] - (true_latency[i] - true_min);
+        if (i >= 64) {
+            error.record(uint32_t(difference < 0 ? -difference : difference));
+        }
+    }
+    const int_fast64_t drift = int_fast64_t(skewed_clock()) - int_fast64_t(hwlib::now_us()) - start_offset;
+    IPASS::Latency_Histogram<>::print_header();
+    estimated.print("estimated latency");
+    error.print("error of the estimate");
+    hwlib::cout << "      " << received << " of " << sent << " payloads, " << estimator.lost() << " lost, jitter "
+                << estimator.jitter_us() << " us, skew " << estimator.skew_ppb() << " ppb, drift of the offset "
+                << drift << " us\n";
+    //a lost last payload isn't seen
+    check(sent - received - estimator.lost() <= 1 and estimator.lost() > 0 and estimator.duplicates() == 0,
+          "RF24L01_Latency_Estimator counts the lost payloads from the sequence numbers");
+    check(estimator.skew_ppb() > 190'000 and estimator.skew_ppb() < 210'000,
+          "RF24L01_Latency_Estimator estimates a skew of 200 ppm");
+    check(error.percentile(990) <= 30 and drift > 1'000,
+          "RF24L01_Latency_Estimator follows the latency within 30 us while the offset drifts");
+    check(estimator.jitter_us() > 0 and estimator.jitter_us() < 400, "RF24L01_Latency_Estimator jitter");
+    check(IPASS::RF24L01_Latency_Estimator::air_time_us(8) == 137 and
+          IPASS::RF24L01_Latency_Estimator::air_time_us(32, true) == 165, "RF24L01_Latency_Estimator air time");
+}
+
+int main() {
+    test_clock();
+    test_APA102();
+    test_HC_SR04();
+    test_RF24L01();
+    test_RF24L01_Config();
+    test_switch_profile();
+    test_no_ack_session();
+    test_ack_channel();
+    test_stream_tx();
+    test_transport();
+    test_link_statistics();
+    test_scanner();
+    test_hopper();
+    test_drain_rx();
+    test_demux();
+    test_async_tx();
+    test_coroutine();
+    test_deadline_scheduler();
+    test_latency_histogram();
+    test_timestamp();
+    test_RX_engine();
+    test_SPI_Profiler();
+    hwlib::cout << (failures == 0 ? "all checks passed\n" : "checks failed\n");
+    return failures == 0 ? 0 : 1;
+}